@@ -2,12 +2,15 @@ import esphome.codegen as cg
 from esphome.core import CORE
 from esphome.components.esp32 import add_idf_sdkconfig_option
 import esphome.config_validation as cv
+import esphome.final_validate as fv
 from esphome.components import ble_client
-from esphome.const import CONF_ID
+from esphome.const import CONF_CODE, CONF_ID, CONF_NAME, CONF_TYPE
+
+from . import gestures, profiles
 
 
 DEPENDENCIES = ['ble_client']
-AUTO_LOAD = ["sensor", "text_sensor"]
+AUTO_LOAD = ["sensor", "text_sensor", "number"]
 CODE_OWNERS=["@fsievers22"]
 
 MULTI_CONF=3
@@ -20,16 +23,426 @@ BLEClientHID = ble_client_hid_ns.class_(
     ble_client.BLEClientNode,
 )
 
-CONFIG_SCHEMA = (
+CONF_PROFILE = "profile"
+CONF_KEY = "key"
+CONF_RELEASE = "release"
+CONF_CONTROLS = "controls"
+CONF_RIGHT = "right"
+CONF_LEFT = "left"
+CONF_BITS = "bits"
+
+def validate_control(config):
+    if config[CONF_TYPE] == profiles.WHEEL:
+        if CONF_RIGHT not in config or CONF_LEFT not in config:
+            raise cv.Invalid(f"a wheel needs {CONF_RIGHT} and {CONF_LEFT} codes")
+    elif CONF_CODE not in config:
+        raise cv.Invalid(f"a {config[CONF_TYPE]} needs a {CONF_CODE}")
+    return config
+
+CONTROL_SCHEMA = cv.All(
     cv.Schema(
         {
-            cv.GenerateID(): cv.declare_id(BLEClientHID)
+            cv.Required(CONF_NAME): cv.string_strict,
+            cv.Optional(CONF_TYPE, default=profiles.BUTTON): cv.one_of(*profiles.CONTROL_TYPES, lower=True),
+            cv.Optional(CONF_CODE): cv.hex_uint16_t,
+            cv.Optional(CONF_RIGHT): cv.hex_uint16_t,
+            cv.Optional(CONF_LEFT): cv.hex_uint16_t,
+            # codes are single report bits, independent of the code field
+            cv.Optional(CONF_BITS, default=False): cv.boolean,
+        }
+    ),
+    validate_control,
+)
+
+def validate_custom_profile(config):
+    if config[CONF_NAME] in profiles.BUILTIN_PROFILES:
+        raise cv.Invalid(f"'{config[CONF_NAME]}' is a built-in profile name")
+    return config
+
+PROFILE_SCHEMA = cv.Any(
+    cv.one_of(*profiles.BUILTIN_PROFILES, lower=True),
+    cv.All(
+        cv.Schema(
+            {
+                cv.Required(CONF_NAME): cv.string_strict,
+                cv.Optional(CONF_KEY, default=profiles.KEY_RAW): cv.one_of(*profiles.KEYS, lower=True),
+                cv.Optional(CONF_RELEASE, default=0x0000): cv.hex_uint16_t,
+                cv.Required(CONF_CONTROLS): cv.All(cv.ensure_list(CONTROL_SCHEMA), cv.Length(min=1)),
+            }
+        ),
+        validate_custom_profile,
+    ),
+)
+
+# Resolves the `profile:` option to a compiled profile (see profiles.py).
+def get_profile(config):
+    value = config[CONF_PROFILE]
+    if isinstance(value, str):
+        return profiles.compile_profile(profiles.BUILTIN_PROFILES[value])
+    return profiles.compile_profile(
+        {
+            "name": value[CONF_NAME],
+            "key": value[CONF_KEY],
+            "release": value[CONF_RELEASE],
+            "controls": [
+                {k: v for k, v in c.items() if k in (CONF_NAME, CONF_TYPE, CONF_CODE, CONF_RIGHT, CONF_LEFT, CONF_BITS)}
+                for c in value[CONF_CONTROLS]
+            ],
+        }
+    )
+
+# Builds the gesture automaton from the built-in patterns of the profile's
+# buttons and the `gestures:` list (see gestures.py).
+def get_gestures(config, compiled):
+    buttons = config[CONF_BUTTONS]
+    return gestures.compile_gestures(
+        compiled,
+        multi_press={name: b[CONF_MULTI_PRESS] for name, b in buttons.items()},
+        speculative={name: b[CONF_SPECULATIVE_SINGLE] for name, b in buttons.items()},
+        patterns=[
+            {
+                "action": g[CONF_ACTION],
+                "sequence": g[CONF_SEQUENCE],
+                "within_ms": g[CONF_WITHIN].total_milliseconds if CONF_WITHIN in g else 0,
+            }
+            for g in config[CONF_GESTURES]
+        ],
+    )
+
+def validate_profile(config):
+    try:
+        compiled = get_profile(config)
+    except profiles.ProfileError as err:
+        raise cv.Invalid(str(err), path=[CONF_PROFILE])
+    for name in config[CONF_BUTTONS]:
+        if name not in compiled["buttons"]:
+            raise cv.Invalid(
+                f"profile '{compiled['name']}' has no button '{name}'", path=[CONF_BUTTONS, name]
+            )
+    try:
+        get_gestures(config, compiled)
+    except gestures.GestureError as err:
+        raise cv.Invalid(str(err), path=[CONF_GESTURES])
+    if CONF_MODES in config:
+        actions = set(profiles.action_names(compiled)) | {g[CONF_ACTION] for g in config[CONF_GESTURES]}
+        for key in (CONF_NEXT, CONF_PREVIOUS):
+            action = config[CONF_MODES].get(key)
+            if action is not None and action not in actions:
+                raise cv.Invalid(f"remote never sends action '{action}'", path=[CONF_MODES, key])
+    return config
+
+CONF_BUTTONS = "buttons"
+CONF_MULTI_PRESS = "multi_press"
+CONF_MULTI_PRESS_GAP = "multi_press_gap"
+CONF_LONG_PRESS = "long_press"
+CONF_SPECULATIVE_SINGLE = "speculative_single"
+CONF_REPEAT = "repeat"
+CONF_DELAY = "delay"
+CONF_INTERVAL = "interval"
+CONF_MIN_INTERVAL = "min_interval"
+CONF_RAMP = "ramp"
+
+REPEAT_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_DELAY, default="500ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_INTERVAL, default="250ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MIN_INTERVAL, default="50ms"): cv.positive_time_period_milliseconds,
+        # each repeat interval is the previous one times this factor
+        cv.Optional(CONF_RAMP, default=0.8): cv.float_range(min=0.1, max=1.0),
+    }
+)
+
+CONF_ADAPTIVE_MULTI_PRESS = "adaptive_multi_press"
+CONF_MIN_GAP = "min_gap"
+CONF_MAX_GAP = "max_gap"
+CONF_PERCENTILE = "percentile"
+CONF_MARGIN = "margin"
+
+def validate_adaptive(config):
+    if config[CONF_MAX_GAP] <= config[CONF_MIN_GAP]:
+        raise cv.Invalid(f"{CONF_MAX_GAP} must be greater than {CONF_MIN_GAP}")
+    return config
+
+ADAPTIVE_MULTI_PRESS_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(CONF_MIN_GAP, default="150ms"): cv.positive_time_period_milliseconds,
+            # gaps longer than this are separate clicks, not cadence; histogram covers up to 1s
+            cv.Optional(CONF_MAX_GAP, default="600ms"): cv.All(
+                cv.positive_time_period_milliseconds,
+                cv.Range(max=cv.TimePeriod(milliseconds=1000)),
+            ),
+            cv.Optional(CONF_PERCENTILE, default=95): cv.int_range(min=50, max=100),
+            cv.Optional(CONF_MARGIN, default="50ms"): cv.positive_time_period_milliseconds,
+        }
+    ),
+    validate_adaptive,
+)
+
+CONF_GESTURES = "gestures"
+CONF_ACTION = "action"
+CONF_SEQUENCE = "sequence"
+CONF_WITHIN = "within"
+
+GESTURE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_ACTION): cv.string_strict,
+        # button names, "<button>:long" for a hold past long_press
+        cv.Required(CONF_SEQUENCE): cv.All(cv.ensure_list(cv.string_strict), cv.Length(min=1)),
+        # wait for each next press; default: the multi-press gap of the last button
+        cv.Optional(CONF_WITHIN): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(milliseconds=1), max=cv.TimePeriod(milliseconds=65535)),
+        ),
+    }
+)
+
+CONF_MODES = "modes"
+CONF_NAMES = "names"
+CONF_NEXT = "next"
+CONF_PREVIOUS = "previous"
+MAX_MODES = 8
+
+def validate_modes(config):
+    if CONF_NEXT not in config and CONF_PREVIOUS not in config:
+        raise cv.Invalid(f"modes need a {CONF_NEXT} or {CONF_PREVIOUS} action")
+    if config.get(CONF_NEXT) == config.get(CONF_PREVIOUS):
+        raise cv.Invalid(f"{CONF_NEXT} and {CONF_PREVIOUS} must be different actions")
+    if len(set(config[CONF_NAMES])) != len(config[CONF_NAMES]):
+        raise cv.Invalid("mode names must be unique")
+    return config
+
+MODES_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Required(CONF_NAMES): cv.All(cv.ensure_list(cv.string_strict), cv.Length(min=2, max=MAX_MODES)),
+            # actions that switch the mode; they are not sent as events themselves
+            cv.Optional(CONF_NEXT): cv.string_strict,
+            cv.Optional(CONF_PREVIOUS): cv.string_strict,
+        }
+    ),
+    validate_modes,
+)
+
+CONF_REMOTES = "remotes"
+CONF_IDLE_RELEASE = "idle_release"
+MAX_POOL_REMOTES = 8
+
+def validate_remotes(value):
+    value = cv.ensure_list(cv.mac_address)(value)
+    if len({str(mac) for mac in value}) != len(value):
+        raise cv.Invalid("remote addresses must be unique")
+    return value
+
+CONF_CONNECTION_PARAMS = "connection_params"
+CONF_ACTIVE_INTERVAL = "active_interval"
+CONF_IDLE_INTERVAL_MIN = "idle_interval_min"
+CONF_IDLE_INTERVAL_MAX = "idle_interval_max"
+CONF_IDLE_LATENCY = "idle_latency"
+CONF_IDLE_AFTER = "idle_after"
+CONF_SUPERVISION_TIMEOUT = "supervision_timeout"
+
+# BLE connection interval limits: 7.5 ms .. 4 s
+conn_interval = cv.All(
+    cv.positive_time_period_microseconds,
+    cv.Range(min=cv.TimePeriod(microseconds=7500), max=cv.TimePeriod(milliseconds=4000)),
+)
+
+# Connection intervals are passed to C++ in controller units of 1.25 ms.
+def interval_units(value):
+    return int(value.total_microseconds // 1250)
+
+def validate_connection_params(config):
+    if config[CONF_IDLE_INTERVAL_MAX] < config[CONF_IDLE_INTERVAL_MIN]:
+        raise cv.Invalid(f"{CONF_IDLE_INTERVAL_MAX} must not be shorter than {CONF_IDLE_INTERVAL_MIN}")
+    # The link must survive the remote skipping `idle_latency` events at the longest interval.
+    longest_us = config[CONF_IDLE_INTERVAL_MAX].total_microseconds * (config[CONF_IDLE_LATENCY] + 1) * 2
+    if config[CONF_SUPERVISION_TIMEOUT].total_milliseconds * 1000 <= longest_us:
+        raise cv.Invalid(
+            f"{CONF_SUPERVISION_TIMEOUT} must be longer than 2 x {CONF_IDLE_INTERVAL_MAX} x ({CONF_IDLE_LATENCY} + 1)"
+        )
+    return config
+
+CONNECTION_PARAMS_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            # while buttons or the wheel are in use; no peripheral latency
+            cv.Optional(CONF_ACTIVE_INTERVAL, default="7500us"): conn_interval,
+            # after `idle_after` without input
+            cv.Optional(CONF_IDLE_INTERVAL_MIN, default="60ms"): conn_interval,
+            cv.Optional(CONF_IDLE_INTERVAL_MAX, default="100ms"): conn_interval,
+            cv.Optional(CONF_IDLE_LATENCY, default=4): cv.int_range(min=0, max=499),
+            cv.Optional(CONF_IDLE_AFTER, default="5s"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_SUPERVISION_TIMEOUT, default="6s"): cv.All(
+                cv.positive_time_period_milliseconds,
+                cv.Range(min=cv.TimePeriod(milliseconds=100), max=cv.TimePeriod(milliseconds=32000)),
+            ),
+        }
+    ),
+    validate_connection_params,
+)
+
+CONF_FAST_RECONNECT = "fast_reconnect"
+CONF_BURST_DURATION = "burst_duration"
+CONF_BURST_INTERVAL = "burst_interval"
+CONF_BURST_WINDOW = "burst_window"
+CONF_IDLE_INTERVAL = "idle_interval"
+CONF_IDLE_WINDOW = "idle_window"
+
+# BLE scan interval / window limits
+scan_time = cv.All(
+    cv.positive_time_period_milliseconds,
+    cv.Range(min=cv.TimePeriod(milliseconds=3), max=cv.TimePeriod(milliseconds=10240)),
+)
+
+def validate_fast_reconnect(config):
+    for interval, window in ((CONF_BURST_INTERVAL, CONF_BURST_WINDOW), (CONF_IDLE_INTERVAL, CONF_IDLE_WINDOW)):
+        if config[window] > config[interval]:
+            raise cv.Invalid(f"{window} must not be longer than {interval}")
+    return config
+
+FAST_RECONNECT_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            # scan hard this long after a disconnect and at boot
+            cv.Optional(CONF_BURST_DURATION, default="10s"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_BURST_INTERVAL, default="40ms"): scan_time,
+            cv.Optional(CONF_BURST_WINDOW, default="40ms"): scan_time,
+            # otherwise
+            cv.Optional(CONF_IDLE_INTERVAL, default="640ms"): scan_time,
+            cv.Optional(CONF_IDLE_WINDOW, default="30ms"): scan_time,
+        }
+    ),
+    validate_fast_reconnect,
+)
+
+CONF_CAPTURE = "capture"
+CONF_BUFFER_SIZE = "buffer_size"
+
+CAPTURE_SCHEMA = cv.Schema(
+    {
+        # notifications kept; 16 bytes of RAM each
+        cv.Optional(CONF_BUFFER_SIZE, default=256): cv.int_range(min=16, max=4096),
+    }
+)
+
+def validate_button(config):
+    if config[CONF_SPECULATIVE_SINGLE] and not config[CONF_MULTI_PRESS]:
+        raise cv.Invalid(f"{CONF_SPECULATIVE_SINGLE} needs {CONF_MULTI_PRESS}: true")
+    return config
+
+BUTTON_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            # false: no double/triple detection, *_single fires at release
+            cv.Optional(CONF_MULTI_PRESS, default=True): cv.boolean,
+            cv.Optional(CONF_MULTI_PRESS_GAP, default="400ms"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_LONG_PRESS, default="1500ms"): cv.positive_time_period_milliseconds,
+            # provisional *_single at release, superseded by a later *_double/*_triple
+            cv.Optional(CONF_SPECULATIVE_SINGLE, default=False): cv.boolean,
+            cv.Optional(CONF_REPEAT): REPEAT_SCHEMA,
+        }
+    ),
+    validate_button,
+)
+
+WheelCurve = ble_client_hid_ns.enum("WheelCurve", is_class=True)
+WHEEL_CURVES = {
+    "none": WheelCurve.NONE,
+    "linear": WheelCurve.LINEAR,
+    "power": WheelCurve.POWER,
+    "table": WheelCurve.TABLE,
+}
+
+CONF_WHEEL_COALESCE_WINDOW = "wheel_coalesce_window"
+CONF_WHEEL_ACCELERATION = "wheel_acceleration"
+CONF_CURVE = "curve"
+CONF_MIN_SPEED = "min_speed"
+CONF_MAX_SPEED = "max_speed"
+CONF_MAX_FACTOR = "max_factor"
+CONF_EXPONENT = "exponent"
+CONF_VELOCITY_WINDOW = "velocity_window"
+CONF_POINTS = "points"
+CONF_SPEED = "speed"
+CONF_FACTOR = "factor"
+
+# Step factors are passed to C++ as Q8 fixed point (256 == 1.0).
+def factor_q8(value):
+    return int(round(value * 256))
+
+def validate_acceleration(config):
+    if config[CONF_MAX_SPEED] <= config[CONF_MIN_SPEED]:
+        raise cv.Invalid(f"{CONF_MAX_SPEED} must be greater than {CONF_MIN_SPEED}")
+    if config[CONF_CURVE] == "table":
+        if not config.get(CONF_POINTS):
+            raise cv.Invalid(f"curve 'table' requires {CONF_POINTS}")
+        speeds = [p[CONF_SPEED] for p in config[CONF_POINTS]]
+        if speeds != sorted(speeds):
+            raise cv.Invalid(f"{CONF_POINTS} must be sorted by {CONF_SPEED}")
+    return config
+
+WHEEL_ACCELERATION_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(CONF_CURVE, default="linear"): cv.enum(WHEEL_CURVES, lower=True),
+            # Speeds are in wheel ticks per second
+            cv.Optional(CONF_MIN_SPEED, default=5): cv.positive_int,
+            cv.Optional(CONF_MAX_SPEED, default=40): cv.positive_int,
+            cv.Optional(CONF_MAX_FACTOR, default=4.0): cv.float_range(min=1.0, max=64.0),
+            cv.Optional(CONF_EXPONENT, default=2): cv.int_range(min=1, max=4),
+            cv.Optional(CONF_VELOCITY_WINDOW, default="150ms"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_POINTS): cv.All(
+                cv.ensure_list(
+                    cv.Schema(
+                        {
+                            cv.Required(CONF_SPEED): cv.positive_int,
+                            cv.Required(CONF_FACTOR): cv.float_range(min=0.0, max=64.0),
+                        }
+                    )
+                ),
+                cv.Length(max=8),
+            ),
+        }
+    ),
+    validate_acceleration,
+)
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(BLEClientHID),
+            cv.Optional(CONF_PROFILE, default=profiles.DEFAULT_PROFILE): PROFILE_SCHEMA,
+            # keyed by the profile's button names
+            cv.Optional(CONF_BUTTONS, default={}): cv.Schema({cv.string_strict: BUTTON_SCHEMA}),
+            cv.Optional(CONF_GESTURES, default=[]): cv.ensure_list(GESTURE_SCHEMA),
+            cv.Optional(CONF_MODES): MODES_SCHEMA,
+            # further remotes sharing this connection slot with the ble_client's own
+            cv.Optional(CONF_REMOTES): cv.All(validate_remotes, cv.Length(min=1, max=MAX_POOL_REMOTES - 1)),
+            # quiet time after which a shared slot is released for the next remote
+            cv.Optional(CONF_IDLE_RELEASE, default="30s"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_FAST_RECONNECT): FAST_RECONNECT_SCHEMA,
+            cv.Optional(CONF_CONNECTION_PARAMS): CONNECTION_PARAMS_SCHEMA,
+            cv.Optional(CONF_CAPTURE): CAPTURE_SCHEMA,
+            cv.Optional(CONF_ADAPTIVE_MULTI_PRESS): ADAPTIVE_MULTI_PRESS_SCHEMA,
+            cv.Optional(CONF_WHEEL_COALESCE_WINDOW, default="0ms"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_WHEEL_ACCELERATION): WHEEL_ACCELERATION_SCHEMA,
         }
     )
     .extend(cv.COMPONENT_SCHEMA)
-    .extend(ble_client.BLE_CLIENT_SCHEMA)
+    .extend(ble_client.BLE_CLIENT_SCHEMA),
+    validate_profile,
 )
 
+def final_validate(config):
+    blocks = fv.full_config.get().get("ble_client_hid", [])
+    if sum(1 for block in blocks if CONF_FAST_RECONNECT in block) > 1:
+        raise cv.Invalid(
+            f"{CONF_FAST_RECONNECT} drives the shared BLE tracker; set it on one ble_client_hid block only"
+        )
+    return config
+
+FINAL_VALIDATE_SCHEMA = final_validate
+
 CONF_BLE_CLIENT_HID_ID = "ble_client_hid_id"
 
 BLE_CLIENT_HID_SCHEMA = cv.Schema(
@@ -50,7 +463,169 @@ async def register_battery_sensor(var, config):
     parent = await cg.get_variable(config[CONF_BLE_CLIENT_HID_ID])
     cg.add(parent.register_battery_sensor(var))
 
+async def register_wheel_number(var, config):
+    parent = await cg.get_variable(config[CONF_BLE_CLIENT_HID_ID])
+    cg.add(parent.register_wheel_number(var))
+
+async def register_notify_queue_depth_sensor(var, config):
+    parent = await cg.get_variable(config[CONF_BLE_CLIENT_HID_ID])
+    cg.add(parent.register_notify_queue_depth_sensor(var))
+
+async def register_notify_latency_sensor(var, config):
+    parent = await cg.get_variable(config[CONF_BLE_CLIENT_HID_ID])
+    cg.add(parent.register_notify_latency_sensor(var))
+
+async def register_notify_overflows_sensor(var, config):
+    parent = await cg.get_variable(config[CONF_BLE_CLIENT_HID_ID])
+    cg.add(parent.register_notify_overflows_sensor(var))
+
+async def register_multi_press_window_sensor(var, config):
+    parent = await cg.get_variable(config[CONF_BLE_CLIENT_HID_ID])
+    cg.add(parent.register_multi_press_window_sensor(var))
+
+async def register_connection_interval_sensor(var, config):
+    parent = await cg.get_variable(config[CONF_BLE_CLIENT_HID_ID])
+    cg.add(parent.register_connection_interval_sensor(var))
+
+async def register_wake_latency_sensor(var, config):
+    parent = await cg.get_variable(config[CONF_BLE_CLIENT_HID_ID])
+    cg.add(parent.register_wake_latency_sensor(var))
+    # advertisements mark the wake
+    cg.add_define("USE_ESP32_BLE_DEVICE")
+
+async def register_mode_text_sensor(var, config):
+    parent = await cg.get_variable(config[CONF_BLE_CLIENT_HID_ID])
+    cg.add(parent.register_mode_text_sensor(var))
+
+def add_profile(compiled):
+    """Emits the profile's tables once per firmware; the built-in Essence header is always there."""
+    emitted = CORE.data.setdefault("ble_client_hid", {}).setdefault("profiles", set())
+    if compiled["name"] not in emitted and compiled["name"] != profiles.DEFAULT_PROFILE:
+        cg.add_global(
+            cg.RawStatement(
+                "namespace esphome {\nnamespace ble_client_hid {\n"
+                + profiles.render_profile(compiled)
+                + "\n}  // namespace ble_client_hid\n}  // namespace esphome"
+            )
+        )
+    emitted.add(compiled["name"])
+    return cg.RawExpression(f"&esphome::ble_client_hid::{profiles.profile_symbol(compiled['name'])}")
+
+def add_gestures(config, compiled):
+    """Emits this remote's automaton, unless it is the built-in one for the default configuration."""
+    table = get_gestures(config, compiled)
+    default = gestures.compile_gestures(profiles.compile_profile(profiles.BUILTIN_PROFILES[profiles.DEFAULT_PROFILE]))
+    if table == default:
+        return cg.RawExpression(f"&esphome::ble_client_hid::{gestures.gestures_symbol(profiles.DEFAULT_PROFILE)}")
+    name = str(config[CONF_ID])
+    cg.add_global(
+        cg.RawStatement(
+            "namespace esphome {\nnamespace ble_client_hid {\n"
+            + gestures.render_gestures(table, name)
+            + "\n}  // namespace ble_client_hid\n}  // namespace esphome"
+        )
+    )
+    return cg.RawExpression(f"&esphome::ble_client_hid::{gestures.gestures_symbol(name)}")
+
+def add_max_buttons_flag():
+    """Sizes per-remote button state for the largest profile in use."""
+    data = CORE.data.setdefault("ble_client_hid", {})
+    if data.get("max_buttons_flag"):
+        return
+    data["max_buttons_flag"] = True
+    max_buttons = max(len(get_profile(conf)["buttons"]) for conf in CORE.config["ble_client_hid"])
+    cg.add_build_flag(f"-DBLE_CLIENT_HID_MAX_BUTTONS={max(1, max_buttons)}")
+
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
     await ble_client.register_ble_node(var, config)
+    compiled = get_profile(config)
+    cg.add(var.set_profile(add_profile(compiled)))
+    cg.add(var.set_gestures(add_gestures(config, compiled)))
+    add_max_buttons_flag()
+    for name, button in config[CONF_BUTTONS].items():
+        index = compiled["buttons"].index(name)
+        cg.add(
+            var.set_button_config(
+                index,
+                button[CONF_MULTI_PRESS],
+                button[CONF_MULTI_PRESS_GAP],
+                button[CONF_LONG_PRESS],
+                button[CONF_SPECULATIVE_SINGLE],
+            )
+        )
+        if CONF_REPEAT in button:
+            repeat = button[CONF_REPEAT]
+            cg.add(
+                var.set_button_repeat(
+                    index,
+                    repeat[CONF_DELAY],
+                    repeat[CONF_INTERVAL],
+                    repeat[CONF_MIN_INTERVAL],
+                    factor_q8(repeat[CONF_RAMP]),
+                )
+            )
+    if CONF_REMOTES in config:
+        # The slot is retargeted from the tracker's advertisements.
+        cg.add_define("USE_ESP32_BLE_DEVICE")
+        for mac in config[CONF_REMOTES]:
+            cg.add(var.add_pool_remote(mac.as_hex))
+        cg.add(var.set_idle_release(config[CONF_IDLE_RELEASE]))
+    if CONF_CONNECTION_PARAMS in config:
+        conn = config[CONF_CONNECTION_PARAMS]
+        active = interval_units(conn[CONF_ACTIVE_INTERVAL])
+        cg.add(
+            var.set_conn_params(
+                active,
+                active,
+                interval_units(conn[CONF_IDLE_INTERVAL_MIN]),
+                interval_units(conn[CONF_IDLE_INTERVAL_MAX]),
+                conn[CONF_IDLE_LATENCY],
+                conn[CONF_SUPERVISION_TIMEOUT].total_milliseconds // 10,
+                conn[CONF_IDLE_AFTER],
+            )
+        )
+    if CONF_FAST_RECONNECT in config:
+        fast = config[CONF_FAST_RECONNECT]
+        cg.add(
+            var.set_scan_duty(
+                fast[CONF_BURST_DURATION],
+                fast[CONF_BURST_INTERVAL],
+                fast[CONF_BURST_WINDOW],
+                fast[CONF_IDLE_INTERVAL],
+                fast[CONF_IDLE_WINDOW],
+            )
+        )
+    if CONF_CAPTURE in config:
+        cg.add(var.set_capture(config[CONF_CAPTURE][CONF_BUFFER_SIZE], f"{config[CONF_ID]}_dump_capture"))
+    if CONF_MODES in config:
+        modes = config[CONF_MODES]
+        for name in modes[CONF_NAMES]:
+            cg.add(var.add_mode(name))
+        cg.add(var.set_mode_actions(modes.get(CONF_NEXT, cg.nullptr), modes.get(CONF_PREVIOUS, cg.nullptr)))
+    if CONF_ADAPTIVE_MULTI_PRESS in config:
+        adaptive = config[CONF_ADAPTIVE_MULTI_PRESS]
+        cg.add(
+            var.set_adaptive_multi_press(
+                adaptive[CONF_MIN_GAP],
+                adaptive[CONF_MAX_GAP],
+                adaptive[CONF_PERCENTILE],
+                adaptive[CONF_MARGIN],
+            )
+        )
+    cg.add(var.set_wheel_coalesce_window(config[CONF_WHEEL_COALESCE_WINDOW]))
+    if CONF_WHEEL_ACCELERATION in config:
+        accel = config[CONF_WHEEL_ACCELERATION]
+        cg.add(
+            var.set_wheel_acceleration(
+                accel[CONF_CURVE],
+                accel[CONF_MIN_SPEED],
+                accel[CONF_MAX_SPEED],
+                factor_q8(accel[CONF_MAX_FACTOR]),
+                accel[CONF_EXPONENT],
+                accel[CONF_VELOCITY_WINDOW],
+            )
+        )
+        for point in accel.get(CONF_POINTS, []):
+            cg.add(var.add_wheel_acceleration_point(point[CONF_SPEED], factor_q8(point[CONF_FACTOR])))
@@ -3,6 +3,11 @@
 
 #ifdef USE_ESP32
 #include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <map>
 #include <sstream>
@@ -13,6 +18,10 @@
 #include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 #include "esphome/core/preferences.h"
+// BLE_HID_NOTIFY_HOOK, see the build-time options below.
+#if defined(BLE_HID_NOTIFY_HOOK) && BLE_HID_NOTIFY_HOOK
+#include "esphome/components/esp32_ble/ble.h"
+#endif
 
 #include <esp_bt.h>
 #include <esp_gap_ble_api.h>
@@ -37,6 +46,16 @@ static const char *const TAG = "ble_client_hid";
 #define BLE_HID_INCLUDE_FALLBACK_PAIR 1
 #endif
 
+#ifndef BLE_HID_NOTIFY_HOOK
+// Set to 1 to stamp and queue notifications on the Bluedroid task, ahead of
+// esp32_ble's event queue, so a busy main loop does not delay their stamps.
+// This takes over esp32_ble's GATTC callback and forwards every event to its
+// protected handler: all BLE clients of the firmware depend on that, and on
+// esp32_ble keeping the handler as it is. Off, notifications are stamped in
+// gattc_event_handler() when esp32_ble dispatches them from the main loop.
+#define BLE_HID_NOTIFY_HOOK 0
+#endif
+
 #if BLE_HID_DEBUG
 #define DBG_LOGI(...) ESP_LOGI(TAG, __VA_ARGS__)
 #define DBG_LOGW(...) ESP_LOGW(TAG, __VA_ARGS__)
@@ -52,39 +71,42 @@ static const char *const TAG = "ble_client_hid";
 static constexpr uint16_t FALLBACK_INPUT_HANDLE = 62;
 static constexpr uint16_t FALLBACK_CCC_HANDLE = 63;
 
-// Multi-press timing (device-side interpretation)
-static constexpr uint32_t MULTIPRESS_GAP_MS = 400;
-static constexpr uint32_t LONG_PRESS_MS = 1500;
+// How often notify queue statistics are published / reset.
+static constexpr uint32_t NOTIFY_STATS_INTERVAL_MS = 10000;
 
-// CCC write guard (avoid spamming)
-static constexpr uint32_t CCC_MIN_INTERVAL_MS = 5000;
+// Capture bytes per log line in dump_capture().
+static constexpr size_t CAPTURE_LINE_BYTES = 32;
 
 // -----------------------------------------------------------------------------
-// Button state (per instance) - only for "real buttons", not wheel events.
+// Helpers
 // -----------------------------------------------------------------------------
-enum class ButtonId : uint8_t { UP = 0, DOWN = 1, LEFT = 2, RIGHT = 3, NONE = 255 };
-
-struct ButtonState {
-  bool is_down{false};
-  bool long_fired{false};
-  uint8_t click_count{0};
+// The tracker, and so its scan duty cycle, is shared by every remote.
+static ScanDuty scan_duty;
+
+// Timestamp for notification records: in gattc_event_handler(), or on the
+// Bluedroid task in notify_hook() with BLE_HID_NOTIFY_HOOK.
+static inline uint32_t notify_clock_us() { return esphome::micros(); }
+
+#if BLE_HID_NOTIFY_HOOK
+// esp32_ble registers the one GATTC callback Bluedroid allows and only queues
+// events for its loop(), where gattc_event_handler() sees them. notify_hook()
+// takes that callback over and passes every event on to esp32_ble's handler.
+struct ESP32BLEGattcChain : esp32_ble::ESP32BLE {
+  using esp32_ble::ESP32BLE::gattc_event_handler;
 };
 
-struct InstanceButtons {
-  std::array<ButtonState, 4> st{};
-  ButtonId active_button{ButtonId::NONE};
-};
-
-static std::map<const BLEClientHID *, InstanceButtons> btn_state_by_instance;
+// Instances notify_hook() serves. Filled in setup(), read on the Bluedroid task.
+static constexpr uint8_t MAX_NOTIFY_TARGETS = 9;  // CONFIG_BT_ACL_CONNECTIONS tops out at 9
+static std::atomic<BLEClientHID *> notify_targets[MAX_NOTIFY_TARGETS];
+static bool notify_hook_installed = false;
 
-// -----------------------------------------------------------------------------
-// Helpers
-// -----------------------------------------------------------------------------
-static std::string hex4(uint16_t v) {
-  std::ostringstream ss;
-  ss << std::hex << std::nouppercase << std::setfill('0') << std::setw(4) << (unsigned) v;
-  return ss.str();
+static uint64_t bda_to_u64(const uint8_t *bda) {
+  uint64_t u = 0;
+  for (int i = 0; i < 6; i++)
+    u = (u << 8) | bda[i];
+  return u;
 }
+#endif
 
 static std::string bytes_hex(const uint8_t *data, size_t len, size_t max_len = 24) {
   std::ostringstream ss;
@@ -97,115 +119,6 @@ static std::string bytes_hex(const uint8_t *data, size_t len, size_t max_len = 2
   return ss.str();
 }
 
-static const char *button_name(ButtonId b) {
-  switch (b) {
-    case ButtonId::UP:
-      return "up";
-    case ButtonId::DOWN:
-      return "down";
-    case ButtonId::LEFT:
-      return "left";
-    case ButtonId::RIGHT:
-      return "right";
-    default:
-      return "unknown";
-  }
-}
-
-static ButtonId raw_to_button_press(uint16_t raw) {
-  // Essence Remote observed:
-  // 0x0006 = Up
-  // 0x0001 = Down
-  // 0x000B = Left
-  // 0x000A = Right
-  switch (raw) {
-    case 0x0006:
-      return ButtonId::UP;
-    case 0x0001:
-      return ButtonId::DOWN;
-    case 0x000B:
-      return ButtonId::LEFT;
-    case 0x000A:
-      return ButtonId::RIGHT;
-    default:
-      return ButtonId::NONE;
-  }
-}
-
-// -----------------------------------------------------------------------------
-// Notify pairs + per-instance BLE/CCC state
-// -----------------------------------------------------------------------------
-struct NotifyPair {
-  uint16_t input_handle{0};  // characteristic value handle
-  uint16_t ccc_handle{0};    // 0x2902 descriptor handle
-
-  bool operator==(const NotifyPair &o) const { return input_handle == o.input_handle && ccc_handle == o.ccc_handle; }
-};
-
-struct CccState {
-  bool enabled{false};
-  uint32_t last_attempt_ms{0};
-};
-
-struct InstanceBleState {
-  std::vector<NotifyPair> pairs;                 // cached + discovered (+ optional fallback)
-  std::map<uint16_t, CccState> ccc_by_ccc;       // keyed by ccc_handle
-  std::map<uint16_t, uint16_t> ccc_value_by_ccc; // desired: 0x0001 notify, 0x0002 indicate
-  bool loaded_pairs{false};
-  uint32_t last_notify_ms{0};
-
-  // HID service range (0x1812), captured from SEARCH_RES_EVT
-  bool have_hid_range{false};
-  uint16_t hid_start{0};
-  uint16_t hid_end{0};
-
-  bool tried_ccc_both_bits{false};
-};
-
-static std::map<const BLEClientHID *, InstanceBleState> ble_state_by_instance;
-
-static void add_pair_unique_(std::vector<NotifyPair> &v, const NotifyPair &p) {
-  if (p.input_handle == 0 || p.ccc_handle == 0)
-    return;
-  for (auto &e : v) {
-    if (e == p)
-      return;
-  }
-  v.push_back(p);
-}
-
-static bool input_is_known_(BLEClientHID *self, uint16_t input_handle) {
-  auto &st = ble_state_by_instance[self];
-  for (auto &p : st.pairs) {
-    if (p.input_handle == input_handle)
-      return true;
-  }
-  return false;
-}
-
-// -----------------------------------------------------------------------------
-// Persisted handle cache (Preferences / NVS) per remote MAC
-// -----------------------------------------------------------------------------
-static constexpr uint32_t HANDLE_CACHE_MAGIC = 0xB0E05A11;
-static constexpr uint8_t HANDLE_CACHE_VERSION = 1;
-static constexpr size_t HANDLE_CACHE_MAX_PAIRS = 6;
-
-struct HandleCacheBlob {
-  uint32_t magic{HANDLE_CACHE_MAGIC};
-  uint8_t version{HANDLE_CACHE_VERSION};
-  uint8_t count{0};
-  uint16_t reserved{0};
-  NotifyPair pairs[HANDLE_CACHE_MAX_PAIRS]{};
-};
-
-struct InstanceHandleCache {
-  bool pref_init{false};
-  bool loaded{false};
-  ESPPreferenceObject pref;
-  HandleCacheBlob blob{};
-};
-
-static std::map<const BLEClientHID *, InstanceHandleCache> handle_cache_by_instance;
 
 static uint32_t fnv1a32_(const char *s) {
   uint32_t h = 2166136261u;
@@ -216,94 +129,61 @@ static uint32_t fnv1a32_(const char *s) {
   return h;
 }
 
-static uint32_t make_pref_key_(BLEClientHID *self) {
-  const char *mac = self->parent()->address_str();
-  uint32_t h = fnv1a32_("ble_client_hid_handle_cache");
-  h ^= fnv1a32_(mac ? mac : "");
-  return h;
-}
-
-static void ensure_pref_(BLEClientHID *self) {
-  auto &hc = handle_cache_by_instance[self];
-  if (hc.pref_init)
-    return;
-  // NOTE: ESPHome requires template type here.
-  hc.pref = esphome::global_preferences->make_preference<HandleCacheBlob>(make_pref_key_(self));
-  hc.pref_init = true;
-}
-
-static void load_cached_pairs_(BLEClientHID *self) {
-  auto &hc = handle_cache_by_instance[self];
-  auto &st = ble_state_by_instance[self];
-  if (hc.loaded)
+// -----------------------------------------------------------------------------
+// Persisted handle cache (Preferences / NVS) per remote MAC
+// -----------------------------------------------------------------------------
+void BLEClientHID::load_cached_pairs() {
+  auto &st = this->ble_state;
+  if (this->handle_cache_loaded)
     return;
 
-  ensure_pref_(self);
-
   HandleCacheBlob tmp;
-  bool ok = hc.pref.load(&tmp);
+  bool ok = this->prefs->handle_cache.load(&tmp);
 
-  st.pairs.clear();
-  st.ccc_by_ccc.clear();
-  st.ccc_value_by_ccc.clear();
-  st.last_notify_ms = 0;
-  st.tried_ccc_both_bits = false;
+  st.clear_pairs();
 
+  auto &blob = this->handle_cache_blob;
   if (ok && tmp.magic == HANDLE_CACHE_MAGIC && tmp.version == HANDLE_CACHE_VERSION) {
-    hc.blob = tmp;
-    for (uint8_t i = 0; i < hc.blob.count && i < HANDLE_CACHE_MAX_PAIRS; i++) {
-      add_pair_unique_(st.pairs, hc.blob.pairs[i]);
+    blob = tmp;
+    for (uint8_t i = 0; i < blob.count && i < HANDLE_CACHE_MAX_PAIRS; i++) {
+      st.add_pair(blob.pairs[i]);
     }
-    // Default desired CCC value to NOTIFY for cached pairs unless discovery later overrides.
-    for (auto &p : st.pairs) {
-      if (p.ccc_handle != 0 && st.ccc_value_by_ccc.find(p.ccc_handle) == st.ccc_value_by_ccc.end()) {
-        st.ccc_value_by_ccc[p.ccc_handle] = 0x0001;
-      }
-    }
-    ESP_LOGI(TAG, "Handle cache loaded for %s: %u pair(s)", self->parent()->address_str(), hc.blob.count);
+    // Desired CCC value defaults to NOTIFY for cached pairs unless discovery later overrides.
+    for (const auto &p : st)
+      st.ccc_entry(p.ccc_handle);
+    ESP_LOGI(TAG, "Handle cache loaded for %s: %u pair(s)", this->parent()->address_str(), blob.count);
   } else {
-    hc.blob = HandleCacheBlob{};
-    hc.blob.magic = HANDLE_CACHE_MAGIC;
-    hc.blob.version = HANDLE_CACHE_VERSION;
-    hc.blob.count = 0;
-    ESP_LOGI(TAG, "Handle cache empty for %s (first run)", self->parent()->address_str());
+    blob = HandleCacheBlob{};
+    ESP_LOGI(TAG, "Handle cache empty for %s (first run)", this->parent()->address_str());
   }
 
 #if BLE_HID_INCLUDE_FALLBACK_PAIR
-  add_pair_unique_(st.pairs, NotifyPair{FALLBACK_INPUT_HANDLE, FALLBACK_CCC_HANDLE});
-  if (FALLBACK_CCC_HANDLE != 0 && st.ccc_value_by_ccc.find(FALLBACK_CCC_HANDLE) == st.ccc_value_by_ccc.end()) {
-    st.ccc_value_by_ccc[FALLBACK_CCC_HANDLE] = 0x0001;
-  }
+  st.add_pair(NotifyPair{FALLBACK_INPUT_HANDLE, FALLBACK_CCC_HANDLE});
+  st.ccc_entry(FALLBACK_CCC_HANDLE);
 #endif
 
-  hc.loaded = true;
+  this->handle_cache_loaded = true;
   st.loaded_pairs = true;
 }
 
-static void save_cached_pairs_(BLEClientHID *self) {
-  auto &hc = handle_cache_by_instance[self];
-  auto &st = ble_state_by_instance[self];
-  if (!hc.pref_init)
+void BLEClientHID::save_cached_pairs() {
+  auto &blob = this->handle_cache_blob;
+  if (!this->handle_cache_loaded)
     return;
 
   HandleCacheBlob out{};
-  out.magic = HANDLE_CACHE_MAGIC;
-  out.version = HANDLE_CACHE_VERSION;
-
   uint8_t n = 0;
-  for (auto &p : st.pairs) {
+  for (const auto &p : this->ble_state) {
     if (n >= HANDLE_CACHE_MAX_PAIRS)
       break;
-    if (p.input_handle == 0 || p.ccc_handle == 0)
-      continue;
     out.pairs[n++] = p;
   }
   out.count = n;
 
-  bool changed = (out.count != hc.blob.count);
+  bool changed = (out.count != blob.count);
   if (!changed) {
     for (uint8_t i = 0; i < out.count; i++) {
-      if (!(out.pairs[i] == hc.blob.pairs[i])) {
+      if (!(out.pairs[i] == blob.pairs[i])) {
         changed = true;
         break;
       }
@@ -312,86 +192,17 @@ static void save_cached_pairs_(BLEClientHID *self) {
   if (!changed)
     return;
 
-  hc.blob = out;
-  hc.pref.save(&hc.blob);
-  ESP_LOGI(TAG, "Handle cache saved for %s: %u pair(s)", self->parent()->address_str(), hc.blob.count);
-}
-
-// -----------------------------------------------------------------------------
-// CCC write + register-for-notify (guarded, per pair)
-// -----------------------------------------------------------------------------
-static void reset_ccc_state_(BLEClientHID *self) {
-  auto &st = ble_state_by_instance[self];
-  st.ccc_by_ccc.clear();
-  st.last_notify_ms = 0;
-  st.tried_ccc_both_bits = false;
-}
-
-static uint16_t desired_ccc_value_(BLEClientHID *self, uint16_t ccc_handle) {
-  auto &st = ble_state_by_instance[self];
-  auto it = st.ccc_value_by_ccc.find(ccc_handle);
-  if (it != st.ccc_value_by_ccc.end())
-    return it->second;
-  return 0x0001;  // default notify
-}
-
-static void write_ccc_and_register_(BLEClientHID *self, const char *reason, bool force, uint16_t input_handle,
-                                    uint16_t ccc_handle, uint16_t ccc_value_override, bool use_override) {
-  auto &st = ble_state_by_instance[self];
-  auto &cs = st.ccc_by_ccc[ccc_handle];
-
-  const uint32_t now = esphome::millis();
-  if (!force && cs.enabled && (now - cs.last_attempt_ms) < CCC_MIN_INTERVAL_MS) {
-    return;
-  }
-  cs.last_attempt_ms = now;
-
-  const uint16_t ccc_u16 = use_override ? ccc_value_override : desired_ccc_value_(self, ccc_handle);
-  uint8_t ccc_value[2] = {static_cast<uint8_t>(ccc_u16 & 0xFF), static_cast<uint8_t>((ccc_u16 >> 8) & 0xFF)};
-
-  esp_err_t r = esp_ble_gattc_write_char_descr(self->parent()->get_gattc_if(), self->parent()->get_conn_id(), ccc_handle,
-                                              sizeof(ccc_value), ccc_value, ESP_GATT_WRITE_TYPE_RSP,
-                                              ESP_GATT_AUTH_REQ_NONE);
-  if (r == ESP_OK) {
-    DBG_LOGI("CCC write ok (ccc=%u) val=0x%04x input=%u (%s)", ccc_handle, ccc_u16, input_handle, reason);
-    cs.enabled = true;
-  } else {
-    DBG_LOGW("CCC write failed (ccc=%u) err=%d val=0x%04x input=%u (%s)", ccc_handle, (int) r, ccc_u16, input_handle,
-             reason);
-  }
-
-  esp_err_t rn =
-      esp_ble_gattc_register_for_notify(self->parent()->get_gattc_if(), self->parent()->get_remote_bda(), input_handle);
-  if (rn != ESP_OK) {
-    DBG_LOGW("register_for_notify failed for input=%u err=%d (%s)", input_handle, (int) rn, reason);
-  }
-}
-
-static void enable_notifications_for_all_pairs_(BLEClientHID *self, const char *reason, bool force) {
-  auto &st = ble_state_by_instance[self];
-  for (auto &p : st.pairs) {
-    write_ccc_and_register_(self, reason, force, p.input_handle, p.ccc_handle, 0, false);
-  }
-}
-
-// One-time fallback: try CCC=0x0003 (notify+indicate bits) without changing desired mapping.
-static void try_enable_ccc_both_bits_once_(BLEClientHID *self, const char *reason) {
-  auto &st = ble_state_by_instance[self];
-  if (st.tried_ccc_both_bits)
-    return;
-  st.tried_ccc_both_bits = true;
-
-  for (auto &p : st.pairs) {
-    write_ccc_and_register_(self, reason, true, p.input_handle, p.ccc_handle, 0x0003, true);
-  }
+  blob = out;
+  this->prefs->handle_cache.save(&blob);
+  ESP_LOGI(TAG, "Handle cache saved for %s: %u pair(s)", this->parent()->address_str(), blob.count);
 }
 
 // -----------------------------------------------------------------------------
 // GATT DB discovery: find HID Report characteristic (0x2A4D) with NOTIFY/INDICATE
 // and its CCC (0x2902), inside HID service range (0x1812).
 // -----------------------------------------------------------------------------
-static void discover_notify_pairs_(BLEClientHID *self, const char *reason) {
-  auto &st = ble_state_by_instance[self];
+void BLEClientHID::discover_notify_pairs(const char *reason) {
+  auto &st = this->ble_state;
 
   uint16_t start = 0x0001;
   uint16_t end = 0xFFFF;
@@ -401,7 +212,7 @@ static void discover_notify_pairs_(BLEClientHID *self, const char *reason) {
   }
 
   uint16_t count = 0;
-  esp_err_t ec = esp_ble_gattc_get_attr_count(self->parent()->get_gattc_if(), self->parent()->get_conn_id(),
+  esp_err_t ec = esp_ble_gattc_get_attr_count(this->parent()->get_gattc_if(), this->parent()->get_conn_id(),
                                              ESP_GATT_DB_ALL, start, end, 0, &count);
   if (ec != ESP_OK || count == 0) {
     ESP_LOGW(TAG, "GATT DB: get_attr_count failed err=%d count=%u range=%u..%u (%s)", (int) ec, count, start, end,
@@ -413,7 +224,7 @@ static void discover_notify_pairs_(BLEClientHID *self, const char *reason) {
   uint16_t out_count = count;
 
   esp_err_t edb =
-      esp_ble_gattc_get_db(self->parent()->get_gattc_if(), self->parent()->get_conn_id(), start, end, db.data(),
+      esp_ble_gattc_get_db(this->parent()->get_gattc_if(), this->parent()->get_conn_id(), start, end, db.data(),
                            &out_count);
   if (edb != ESP_OK || out_count == 0) {
     ESP_LOGW(TAG, "GATT DB: get_db failed err=%d count=%u range=%u..%u (%s)", (int) edb, out_count, start, end, reason);
@@ -431,19 +242,23 @@ static void discover_notify_pairs_(BLEClientHID *self, const char *reason) {
   auto flush = [&]() {
     if (cur_input != 0 && cur_ccc != 0 && (cur_notify || cur_indicate)) {
       NotifyPair np{cur_input, cur_ccc};
-      const size_t before = st.pairs.size();
-      add_pair_unique_(st.pairs, np);
+      const bool added = st.add_pair(np);
 
       // Choose desired CCC based on properties: notify preferred else indicate.
-      const uint16_t want = cur_notify ? 0x0001 : 0x0002;
-      st.ccc_value_by_ccc[np.ccc_handle] = want;
+      const uint16_t want = cur_notify ? CCC_NOTIFY : CCC_INDICATE;
+      CccEntry *cs = st.ccc_entry(np.ccc_handle);
+      if (cs != nullptr)
+        cs->desired = want;
 
-      if (st.pairs.size() != before) {
+      if (added) {
         // INFO on purpose (useful even without BLE_HID_DEBUG)
         ESP_LOGI(TAG, "HID notify candidate: input=%u ccc=%u mode=%s props=0x%02x", np.input_handle, np.ccc_handle,
-                 (want == 0x0002 ? "indicate" : "notify"), cur_props);
-      } else {
+                 (want == CCC_INDICATE ? "indicate" : "notify"), cur_props);
+      } else if (st.has_pair(np)) {
         DBG_LOGI("DBG: candidate already known: input=%u ccc=%u", np.input_handle, np.ccc_handle);
+      } else {
+        ESP_LOGW(TAG, "HID notify candidate input=%u ccc=%u dropped, already %u pairs", np.input_handle,
+                 np.ccc_handle, (unsigned) MAX_NOTIFY_PAIRS);
       }
     }
 
@@ -484,21 +299,266 @@ static void discover_notify_pairs_(BLEClientHID *self, const char *reason) {
   flush();
 
   // If we discovered new pairs, persist them.
-  save_cached_pairs_(self);
+  this->save_cached_pairs();
 }
 
 // -----------------------------------------------------------------------------
 // Component implementation
 // -----------------------------------------------------------------------------
+void BLEClientHID::setup() {
+  this->pipeline.set_profile(this->profile);
+  this->pipeline.set_gestures(this->gestures_table);
+  this->pipeline.set_sink([this](const RemoteEvent &event) { this->emit_event(event); });
+  if (this->wheel_number != nullptr)
+    this->pipeline.set_wheel_delta_sink([this](int16_t delta) { this->wheel_number->apply_delta(delta); });
+
+  this->subscriber.set_state(&this->ble_state);
+  // `reason` only reaches the log with BLE_HID_DEBUG.
+  this->subscriber.set_write_ccc_function([this](uint16_t ccc_handle, uint16_t value,
+                                                 [[maybe_unused]] const char *reason) {
+    uint8_t ccc_value[2] = {static_cast<uint8_t>(value & 0xFF), static_cast<uint8_t>((value >> 8) & 0xFF)};
+    esp_err_t r = esp_ble_gattc_write_char_descr(this->parent()->get_gattc_if(), this->parent()->get_conn_id(),
+                                                ccc_handle, sizeof(ccc_value), ccc_value, ESP_GATT_WRITE_TYPE_RSP,
+                                                ESP_GATT_AUTH_REQ_NONE);
+    if (r == ESP_OK) {
+      DBG_LOGI("CCC write ok (ccc=%u) val=0x%04x (%s)", ccc_handle, value, reason);
+    } else {
+      DBG_LOGW("CCC write failed (ccc=%u) err=%d val=0x%04x (%s)", ccc_handle, (int) r, value, reason);
+    }
+    return r == ESP_OK;
+  });
+  this->subscriber.set_register_function([this](uint16_t input_handle, [[maybe_unused]] const char *reason) {
+    esp_err_t r = esp_ble_gattc_register_for_notify(this->parent()->get_gattc_if(), this->parent()->get_remote_bda(),
+                                                    input_handle);
+    if (r != ESP_OK) {
+      DBG_LOGW("register_for_notify failed for input=%u err=%d (%s)", input_handle, (int) r, reason);
+    }
+    return r == ESP_OK;
+  });
+
+  this->read_queue.set_issue_function([this](uint16_t handle) {
+    esp_err_t r = esp_ble_gattc_read_char(this->parent()->get_gattc_if(), this->parent()->get_conn_id(), handle,
+                                          ESP_GATT_AUTH_REQ_NONE);
+    if (r != ESP_OK) {
+      DBG_LOGW("read_char failed for handle=%u err=%d", handle, (int) r);
+    }
+    return r == ESP_OK;
+  });
+
+  this->scheduler.add_remote(this->parent()->get_address());
+  for (uint8_t i = 0; i < this->scheduler.size(); i++)
+    this->make_remote_prefs(this->scheduler.remote(i).mac);
+  if (this->scheduler.find(this->parent()->get_address()) == POOL_NONE)
+    this->make_remote_prefs(this->parent()->get_address());
+  this->select_remote_prefs(this->parent()->get_address());
+  this->load_remote_prefs();
+
+#if BLE_HID_NOTIFY_HOOK
+  this->notify_address.store(this->parent()->get_address(), std::memory_order_relaxed);
+  for (auto &target : notify_targets) {
+    if (target.load(std::memory_order_relaxed) == nullptr) {
+      target.store(this, std::memory_order_release);
+      break;
+    }
+  }
+#endif
+
+  // The remote is expected to connect right after boot.
+  scan_duty.burst(esphome::millis());
+#ifdef USE_ESP32_BLE_DEVICE
+  // Advertisements are only needed to share the slot or to time wakes.
+  if (this->scheduler.is_pooled() || this->wake_latency_sensor != nullptr)
+    espbt::global_esp32_ble_tracker->register_listener(&this->pool_listener);
+#endif
+
+#ifdef USE_API
+  if (this->capture.is_enabled())
+    this->register_service(&BLEClientHID::dump_capture, this->capture_service);
+  if (this->wheel_number != nullptr && !this->wheel_number->get_seed_entity_id().empty()) {
+    this->subscribe_homeassistant_state(&BLEClientHID::on_wheel_seed_state, this->wheel_number->get_seed_entity_id(),
+                                        this->wheel_number->get_seed_attribute());
+  }
+#endif
+}
+
+// Handle cache, learned window and mode are kept per remote MAC.
+void BLEClientHID::make_remote_prefs(uint64_t mac) {
+  if (this->remote_prefs_count >= MAX_POOL_REMOTES + 1)
+    return;
+  // Keyed on the address as BLEClient::address_str() prints it.
+  char addr[18];
+  snprintf(addr, sizeof(addr), "%02X:%02X:%02X:%02X:%02X:%02X", (unsigned) (mac >> 40) & 0xFF,
+           (unsigned) (mac >> 32) & 0xFF, (unsigned) (mac >> 24) & 0xFF, (unsigned) (mac >> 16) & 0xFF,
+           (unsigned) (mac >> 8) & 0xFF, (unsigned) mac & 0xFF);
+  const uint32_t mac_key = fnv1a32_(addr);
+  RemotePrefs &prefs = this->remote_prefs[this->remote_prefs_count++];
+  prefs.mac = mac;
+  // NOTE: ESPHome requires template type here.
+  prefs.handle_cache =
+      esphome::global_preferences->make_preference<HandleCacheBlob>(fnv1a32_("ble_client_hid_handle_cache") ^ mac_key);
+  if (this->pipeline.gestures().adaptive().is_enabled()) {
+    prefs.adaptive = esphome::global_preferences->make_preference<AdaptiveGapBlob>(
+        fnv1a32_("ble_client_hid_adaptive_gap") ^ mac_key);
+  }
+  if (this->modes.is_enabled())
+    prefs.mode = esphome::global_preferences->make_preference<ModeBlob>(fnv1a32_("ble_client_hid_mode") ^ mac_key);
+}
+
+void BLEClientHID::select_remote_prefs(uint64_t mac) {
+  for (uint8_t i = 0; i < this->remote_prefs_count; i++) {
+    if (this->remote_prefs[i].mac == mac) {
+      this->prefs = &this->remote_prefs[i];
+      return;
+    }
+  }
+}
+
+void BLEClientHID::load_remote_prefs() {
+  AdaptiveGapWindow &adaptive = this->pipeline.gestures().adaptive();
+  if (adaptive.is_enabled()) {
+    AdaptiveGapBlob blob;
+    if (this->prefs->adaptive.load(&blob) && adaptive.load(blob)) {
+      ESP_LOGI(TAG, "Adaptive multi-press window restored: %ums from %u gap(s)", (unsigned) adaptive.window_ms(),
+               (unsigned) adaptive.samples());
+    } else {
+      adaptive.clear();
+    }
+    if (this->multi_press_window_sensor != nullptr)
+      this->multi_press_window_sensor->publish_state(adaptive.window_ms());
+  }
+
+  if (this->modes.is_enabled()) {
+    ModeBlob blob;
+    if (this->prefs->mode.load(&blob) && this->modes.load(blob)) {
+      ESP_LOGI(TAG, "Mode restored: %s", this->modes.current_name());
+    } else {
+      this->modes.select(0);
+    }
+    if (this->mode_text_sensor != nullptr)
+      this->mode_text_sensor->publish_state(this->modes.current_name());
+  }
+}
+
 void BLEClientHID::loop() {
-  // No periodic work required.
+#if BLE_HID_NOTIFY_HOOK
+  this->install_notify_hook();
+#endif
+
+  // Decode what the NOTIFY path queued, a bounded batch per iteration.
+  this->notify_stats.record_depth(this->notify_queue.size());
+  // Gestures run on arrival time: deadlines that passed before a record
+  // arrived fire before it is decoded, however late this loop() is.
+  NotifyRecord rec;
+  uint8_t drained = 0;
+  for (; drained < NOTIFY_DRAIN_BATCH && this->notify_queue.pop(rec); drained++) {
+    if (rec.len < 2)
+      DBG_LOGW("HID notify too short: len=%u", (unsigned) rec.len);
+    this->capture.add(this->parent()->get_address(), rec);
+    this->pipeline.feed(rec);
+    this->notify_stats.record_latency(notify_clock_us() - rec.t_us);
+  }
+  const uint32_t now = esphome::millis();
+  this->pipeline.poll(notify_clock_us(), now);
+  if (this->pipeline.gestures().take_window_changed())
+    this->save_adaptive_window();
+
+  uint32_t wake_latency_ms;
+  if (drained > 0 && this->scheduler.on_activity(now, wake_latency_ms)) {
+    ESP_LOGI(TAG, "[%s] Wake to first event: %ums", this->parent()->address_str(), (unsigned) wake_latency_ms);
+    if (this->wake_latency_sensor != nullptr)
+      this->wake_latency_sensor->publish_state(wake_latency_ms);
+  }
+  if (this->hid_state == HIDState::CONN_PARAMS_UPDATING && this->conn_policy.update_expired(now)) {
+    ESP_LOGW(TAG, "[%s] Connection parameter update not answered", this->parent()->address_str());
+    this->hid_state = HIDState::CONFIGURED;
+  }
+  // Input during an update still counts; the stack applies a new request
+  // after the one in progress.
+  if (this->hid_state == HIDState::CONFIGURED || this->hid_state == HIDState::CONN_PARAMS_UPDATING) {
+    if (drained > 0 && this->conn_policy.on_input(now)) {
+      this->request_conn_params(LinkProfile::ACTIVE);
+    } else if (this->conn_policy.poll(now)) {
+      this->request_conn_params(LinkProfile::IDLE);
+    }
+  }
+  this->subscriber.loop(now);
+  this->apply_scan_duty(now);
+  if (this->scheduler.should_release(now)) {
+    ESP_LOGI(TAG, "[%s] Idle for %ums, releasing the connection slot", this->parent()->address_str(),
+             (unsigned) this->scheduler.idle_release_ms());
+    this->scheduler.on_disconnected();
+    this->releasing_idle = true;
+    this->parent()->disconnect();
+  }
+  if (now - this->last_stats_publish_ms >= NOTIFY_STATS_INTERVAL_MS) {
+    this->last_stats_publish_ms = now;
+    this->publish_notify_stats();
+  }
+
+  this->read_queue.loop(now);
+
+  if (this->hid_state == HIDState::READING_CHARS && this->read_queue.idle()) {
+    this->hid_state = HIDState::READ_CHARS;
+    this->configure_hid_client();
+  }
 }
 
 void BLEClientHID::dump_config() {
   ESP_LOGCONFIG(TAG, "BLE Client HID (B&O Remote):");
   ESP_LOGCONFIG(TAG, " MAC address : %s", this->parent()->address_str());
-  ESP_LOGCONFIG(TAG, " multi-press gap : %ums", (unsigned) MULTIPRESS_GAP_MS);
-  ESP_LOGCONFIG(TAG, " long press : %ums", (unsigned) LONG_PRESS_MS);
+  ESP_LOGCONFIG(TAG, " profile : %s (%u controls)", this->profile->name, (unsigned) this->profile->control_count);
+  ESP_LOGCONFIG(TAG, " gestures : %u states", (unsigned) this->gestures_table->state_count);
+  for (uint8_t i = 0; i < this->pipeline.gestures().button_count(); i++) {
+    const auto &cfg = this->pipeline.gestures().config((ButtonId) i);
+    const char *name = this->profile->button_name((ButtonId) i);
+    if (cfg.multi_press) {
+      ESP_LOGCONFIG(TAG, " button %s : multi-press gap %ums, long press %ums%s", name,
+                    (unsigned) cfg.multi_press_gap_ms, (unsigned) cfg.long_press_ms,
+                    cfg.speculative_single ? ", speculative single" : "");
+    } else {
+      ESP_LOGCONFIG(TAG, " button %s : single only, long press %ums", name, (unsigned) cfg.long_press_ms);
+    }
+    if (cfg.repeat) {
+      ESP_LOGCONFIG(TAG, " button %s : repeat after %ums every %ums (min %ums)", name,
+                    (unsigned) cfg.repeat_delay_ms, (unsigned) cfg.repeat_interval_ms,
+                    (unsigned) cfg.repeat_min_interval_ms);
+    }
+  }
+  if (this->scheduler.is_pooled()) {
+    ESP_LOGCONFIG(TAG, " shared slot : %u remotes, idle release after %ums", (unsigned) this->scheduler.size(),
+                  (unsigned) this->scheduler.idle_release_ms());
+  }
+  if (this->conn_policy.is_enabled()) {
+    const LinkParams &active = this->conn_policy.params(LinkProfile::ACTIVE);
+    const LinkParams &idle = this->conn_policy.params(LinkProfile::IDLE);
+    ESP_LOGCONFIG(TAG, " connection interval : %.2f-%.2fms active, %.2f-%.2fms latency %u after %ums idle",
+                  active.min_interval * 1.25f, active.max_interval * 1.25f, idle.min_interval * 1.25f,
+                  idle.max_interval * 1.25f, (unsigned) idle.latency, (unsigned) this->conn_policy.idle_after_ms());
+  }
+  if (scan_duty.is_enabled()) {
+    ESP_LOGCONFIG(TAG, " scan duty : %u/%ums for %ums after a disconnect, else %u/%ums",
+                  (unsigned) scan_duty.burst_params().window_ms, (unsigned) scan_duty.burst_params().interval_ms,
+                  (unsigned) scan_duty.burst_ms(), (unsigned) scan_duty.idle_params().window_ms,
+                  (unsigned) scan_duty.idle_params().interval_ms);
+  }
+  if (this->modes.is_enabled()) {
+    ESP_LOGCONFIG(TAG, " modes : %u, current %s", (unsigned) this->modes.count(), this->modes.current_name());
+  }
+  const AdaptiveGapWindow &adaptive = this->pipeline.gestures().adaptive();
+  if (adaptive.is_enabled()) {
+    ESP_LOGCONFIG(TAG, " adaptive multi-press window : %ums (%u gap(s) learned)", (unsigned) adaptive.window_ms(),
+                  (unsigned) adaptive.samples());
+  }
+  ESP_LOGCONFIG(TAG, " wheel coalesce window : %ums", (unsigned) this->pipeline.wheel().get_window_ms());
+  ESP_LOGCONFIG(TAG, " wheel acceleration : %s (velocity window %ums)",
+                WHEEL_CURVE_NAMES[(uint8_t) this->pipeline.wheel().acceleration().get_curve()],
+                (unsigned) (this->pipeline.wheel().velocity().get_window_us() / 1000));
+  ESP_LOGCONFIG(TAG, " notify queue : %u records, batch %u", (unsigned) NotifyQueue::capacity(),
+                (unsigned) NOTIFY_DRAIN_BATCH);
+  if (this->capture.is_enabled()) {
+    ESP_LOGCONFIG(TAG, " capture : last %u notifications, service %s", (unsigned) this->capture.capacity(),
+                  this->capture_service.c_str());
+  }
 
 #if BLE_HID_DEBUG
   ESP_LOGCONFIG(TAG, " debug : enabled");
@@ -514,21 +574,90 @@ void BLEClientHID::dump_config() {
 }
 
 void BLEClientHID::gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param) {
-  (void) param;
   if (event == ESP_GAP_BLE_AUTH_CMPL_EVT) {
     // After auth, some remotes start accepting CCC writes reliably.
-    load_cached_pairs_(this);
-    enable_notifications_for_all_pairs_(this, "auth_complete", true);
+    this->load_cached_pairs();
+    this->subscriber.on_auth_complete(esphome::millis());
+  } else if (event == ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT) {
+    // Sent for every link; ours only. Also covers updates the remote asked for.
+    const auto &up = param->update_conn_params;
+    if (memcmp(up.bda, this->parent()->get_remote_bda(), sizeof(esp_bd_addr_t)) != 0)
+      return;
+    if (this->hid_state == HIDState::CONN_PARAMS_UPDATING)
+      this->hid_state = HIDState::CONFIGURED;
+    if (up.status != 0) {
+      ESP_LOGW(TAG, "[%s] Connection parameter update failed, status=%d", this->parent()->address_str(),
+               (int) up.status);
+      this->conn_policy.on_request_failed();
+      return;
+    }
+    this->conn_policy.on_updated(up.conn_int);
+    DBG_LOGI("Connection interval %u x 1.25ms, latency %u, timeout %u x 10ms", up.conn_int, up.latency, up.timeout);
+    if (this->connection_interval_sensor != nullptr)
+      this->connection_interval_sensor->publish_state(up.conn_int * 1.25f);
   }
 }
 
-void BLEClientHID::read_client_characteristics() {}
+#if BLE_HID_NOTIFY_HOOK
+// -----------------------------------------------------------------------------
+// Notification hook (Bluedroid task), BLE_HID_NOTIFY_HOOK only
+// -----------------------------------------------------------------------------
+// Called every loop(): the client gets a new interface when the stack restarts.
+void BLEClientHID::install_notify_hook() {
+  const esp_gatt_if_t gattc_if = this->parent()->get_gattc_if();
+  // esp32_ble registers its callback before the client gets an interface;
+  // installing earlier would be undone by it.
+  if (gattc_if == ESP_GATT_IF_NONE)
+    return;
+  this->notify_gattc_if.store(gattc_if, std::memory_order_relaxed);
+  if (notify_hook_installed)
+    return;
+  esp_err_t r = esp_ble_gattc_register_callback(&BLEClientHID::notify_hook);
+  if (r != ESP_OK) {
+    DBG_LOGW("register_callback for the notify hook failed err=%d", (int) r);
+    return;
+  }
+  notify_hook_installed = true;
+}
 
-void BLEClientHID::on_gatt_read_finished(GATTReadData *data) { (void) data; }
+// Stamps and queues notifications the moment Bluedroid delivers them, however
+// long the main loop is busy, then hands every event on to esp32_ble.
+void BLEClientHID::notify_hook(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if, esp_ble_gattc_cb_param_t *param) {
+  if (event == ESP_GATTC_NOTIFY_EVT) {
+    const uint32_t t_us = notify_clock_us();
+    for (auto &target : notify_targets) {
+      BLEClientHID *hid = target.load(std::memory_order_acquire);
+      if (hid != nullptr && hid->enqueue_notify(gattc_if, param, t_us))
+        break;
+    }
+  }
+  ESP32BLEGattcChain::gattc_event_handler(event, gattc_if, param);
+}
+
+bool BLEClientHID::enqueue_notify(esp_gatt_if_t gattc_if, const esp_ble_gattc_cb_param_t *param, uint32_t t_us) {
+  if (!this->is_own_notify(gattc_if, param))
+    return false;
+  // Enqueue only; decoding and event emission happen in loop().
+  if (param->notify.value_len >= 2) {
+    NotifyRecord rec;
+    rec.assign(param->notify.handle, param->notify.value, param->notify.value_len, t_us);
+    this->notify_queue.push(rec);
+  }
+  this->hook_notifies.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+bool BLEClientHID::is_own_notify(esp_gatt_if_t gattc_if, const esp_ble_gattc_cb_param_t *param) const {
+  return gattc_if == this->notify_gattc_if.load(std::memory_order_relaxed) &&
+         bda_to_u64(param->notify.remote_bda) == this->notify_address.load(std::memory_order_relaxed);
+}
+#endif
 
 void BLEClientHID::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if,
                                        esp_ble_gattc_cb_param_t *param) {
+#if !BLE_HID_NOTIFY_HOOK
   (void) gattc_if;
+#endif
 
   switch (event) {
     case ESP_GATTC_CONNECT_EVT: {
@@ -542,30 +671,16 @@ void BLEClientHID::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t
     }
 
     case ESP_GATTC_OPEN_EVT: {
-      load_cached_pairs_(this);
-
-      // Important for "first press after wake": try enabling quickly from cache.
-      this->set_timeout("post_open_enable_fast", 80, [this]() {
-        load_cached_pairs_(this);
-        enable_notifications_for_all_pairs_(this, "post_open_fast", false);
-      });
-
-      // Retry after a short delay (lets the stack settle).
-      this->set_timeout("post_open_enable", 600, [this]() {
-        load_cached_pairs_(this);
-        enable_notifications_for_all_pairs_(this, "post_open", false);
-      });
-
-      // One more retry, plus an optional CCC=0x0003 fallback if no traffic.
-      this->set_timeout("ccc_retry", 2000, [this]() {
-        load_cached_pairs_(this);
-        enable_notifications_for_all_pairs_(this, "open_retry", false);
-
-        auto &st = ble_state_by_instance[this];
-        if (st.last_notify_ms == 0) {
-          try_enable_ccc_both_bits_once_(this, "ccc_both_bits_fallback");
-        }
-      });
+      this->scheduler.on_connected(esphome::millis());
+      this->conn_policy.reset(esphome::millis());
+      this->load_cached_pairs();
+
+      // Important for "first press after wake": enable quickly from the cache,
+      // then retry (see SubscribeStrategy).
+      this->subscriber.on_open(esphome::millis());
+
+      this->wheel_seed_pending = true;
+      this->apply_wheel_seed();
 
       this->node_state = espbt::ClientState::ESTABLISHED;
       break;
@@ -577,7 +692,7 @@ void BLEClientHID::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t
 
       // IMPORTANT: In ESP-IDF 5.5.x, sr.srvc_id is esp_gatt_id_t (NO ".id" member).
       if (sr.srvc_id.uuid.len == ESP_UUID_LEN_16 && sr.srvc_id.uuid.uuid.uuid16 == 0x1812) {
-        auto &st = ble_state_by_instance[this];
+        auto &st = this->ble_state;
         st.have_hid_range = true;
         st.hid_start = sr.start_handle;
         st.hid_end = sr.end_handle;
@@ -588,30 +703,63 @@ void BLEClientHID::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t
     }
 
     case ESP_GATTC_SEARCH_CMPL_EVT: {
-      load_cached_pairs_(this);
+      this->load_cached_pairs();
+
+      this->discover_notify_pairs("search_complete");
+      this->subscriber.on_search_complete(esphome::millis());
 
-      discover_notify_pairs_(this, "search_complete");
-      enable_notifications_for_all_pairs_(this, "search_complete", false);
+      // Notifications first (first-press race), then the setup reads back to back.
+      this->read_client_characteristics();
+      break;
+    }
+
+    case ESP_GATTC_READ_CHAR_EVT: {
+      if (param->read.conn_id != this->parent()->get_conn_id())
+        break;
+      this->read_queue.on_read_result(param->read.handle, (int) param->read.status, param->read.value,
+                                      param->read.value_len, esphome::millis());
       break;
     }
 
     case ESP_GATTC_DISCONNECT_EVT: {
       ESP_LOGW(TAG, "[%s] Disconnected!", this->parent()->address_str());
       this->status_set_warning("Disconnected");
-      reset_ccc_state_(this);
-      btn_state_by_instance[this] = InstanceButtons{};
+      this->subscriber.on_disconnect();
+      this->scheduler.on_disconnected();
+      // A remote that just dropped often comes straight back; one we released
+      // for being idle does not.
+      if (!this->releasing_idle)
+        scan_duty.burst(esphome::millis());
+      this->releasing_idle = false;
+      this->pipeline.reset();
+      this->read_queue.clear();
+      this->hid_state = HIDState::INIT;
       break;
     }
 
     case ESP_GATTC_NOTIFY_EVT: {
+#if BLE_HID_NOTIFY_HOOK
+      // notify_hook() counts every notification it queued. One it did not
+      // count went past it: esp32_ble took the callback back, e.g. after the
+      // stack was disabled and enabled again. The hook is the queue's only
+      // producer, so that one is lost; install the hook again.
+      if (this->is_own_notify(gattc_if, param)) {
+        if ((int32_t) (this->hook_notifies.load(std::memory_order_acquire) - this->loop_notifies) > 0) {
+          this->loop_notifies++;
+        } else {
+          ESP_LOGW(TAG, "[%s] Notification bypassed the notify hook, installing it again",
+                   this->parent()->address_str());
+          notify_hook_installed = false;
+        }
+      }
+#endif
       if (param->notify.conn_id != this->parent()->get_conn_id())
         break;
 
-      auto &st = ble_state_by_instance[this];
-      st.last_notify_ms = esphome::millis();
+      this->subscriber.on_notify(esphome::millis());
 
       const uint16_t h = param->notify.handle;
-      const bool known = input_is_known_(this, h);
+      const bool known = this->ble_state.input_is_known(h);
 
 #if BLE_HID_DEBUG
       DBG_LOGI("DBG notify%s: handle=%u len=%u data=%s", known ? "" : "(unknown)", h,
@@ -620,9 +768,14 @@ void BLEClientHID::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t
       (void) known;
 #endif
 
+#if !BLE_HID_NOTIFY_HOOK
+      // Enqueue only; decoding and event emission happen in loop().
       if (param->notify.value_len >= 2) {
-        this->send_input_report_event(param);
+        NotifyRecord rec;
+        rec.assign(h, param->notify.value, param->notify.value_len, notify_clock_us());
+        this->notify_queue.push(rec);
       }
+#endif
 
       break;
     }
@@ -635,184 +788,416 @@ void BLEClientHID::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t
 // -----------------------------------------------------------------------------
 // Notify parsing + event emission
 // -----------------------------------------------------------------------------
-void BLEClientHID::send_input_report_event(esp_ble_gattc_cb_param_t *p_data) {
-  if (p_data->notify.value_len < 2) {
-    DBG_LOGW("HID notify too short: len=%u", (unsigned) p_data->notify.value_len);
+void BLEClientHID::emit_event(const RemoteEvent &event) {
+  // A switch action is consumed here; a provisional one is not final yet.
+  if (!event.provisional && this->modes.handle_action(event.action)) {
+    this->switch_mode();
     return;
   }
 
-  uint16_t raw = ((uint16_t) p_data->notify.value[0] << 8) | (uint16_t) p_data->notify.value[1];
-  const std::string raw_hex = hex4(raw);
-
+  // Everything up to here is allocation free; the API and sensor calls below take
+  // std::string / std::map by contract and are the hand-off point.
+  const EventText text(event);
   const char *remote = this->parent()->address_str();
-  const std::string source = esphome::App.get_name();
+  const std::string &source = esphome::App.get_name();
+  const char *mode = this->modes.current_name();
 
-  auto emit = [&](const std::string &action, int clicks, const std::string &raw_for_event) {
 #ifdef USE_API
-    std::map<std::string, std::string> data;
-    data["action"] = action;
-    data["raw"] = raw_for_event;
-    data["clicks"] = std::to_string(clicks);
-    data["remote"] = remote ? remote : "";
-    data["source"] = source;
-    this->fire_homeassistant_event("esphome.remote_action", data);
+  this->fire_homeassistant_event("esphome.remote_action", event_data(event, text, remote, source, mode));
 #endif
 
-    if (this->last_event_usage_text_sensor != nullptr) {
-      this->last_event_usage_text_sensor->publish_state(action);
-    }
-    if (this->last_event_value_sensor != nullptr) {
-      this->last_event_value_sensor->publish_state(0.0f);
-    }
+  if (this->last_event_usage_text_sensor != nullptr) {
+    this->last_event_usage_text_sensor->publish_state(text.action);
+  }
+  if (this->last_event_value_sensor != nullptr) {
+    this->last_event_value_sensor->publish_state(0.0f);
+  }
+
+  ESP_LOGI(TAG, "Remote action: %s remote=%s source=%s raw=%s clicks=%s mode=%s", text.action,
+           remote ? remote : "", source.c_str(), text.raw, text.clicks, mode ? mode : "");
+}
+
+void BLEClientHID::switch_mode() {
+  ESP_LOGI(TAG, "[%s] Mode: %s", this->parent()->address_str(), this->modes.current_name());
+  // Written to flash on the preferences flush interval, not on every change.
+  ModeBlob blob;
+  this->modes.store(blob);
+  this->prefs->mode.save(&blob);
+  if (this->mode_text_sensor != nullptr)
+    this->mode_text_sensor->publish_state(this->modes.current_name());
+  // Tells automations the layer changed; carries the new mode like any event.
+  this->emit_event(RemoteEvent{"mode_changed", 0, false, -1});
+}
 
-    ESP_LOGI(TAG, "Remote action: %s remote=%s source=%s raw=%s clicks=%d", action.c_str(), remote ? remote : "",
-             source.c_str(), raw_for_event.c_str(), clicks);
+// Writes the capture to the log as hex lines; host/replay_hid reads them back.
+void BLEClientHID::dump_capture() {
+  ESP_LOGI(TAG, "[%s] Capture of %u notification(s) follows", this->parent()->address_str(),
+           (unsigned) this->capture.size());
+  static const char DIGITS[] = "0123456789abcdef";
+  char line[CAPTURE_LINE_BYTES * 2 + 1];
+  size_t n = 0;
+  auto write_hex = [&line, &n](const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      line[n++] = DIGITS[data[i] >> 4];
+      line[n++] = DIGITS[data[i] & 0xF];
+      if (n == CAPTURE_LINE_BYTES * 2) {
+        line[n] = '\0';
+        ESP_LOGI(TAG, "capture: %s", line);
+        n = 0;
+      }
+    }
   };
+  this->capture.write(this->profile->name, this->gestures_table->state_count, write_hex);
+  if (n > 0) {
+    line[n] = '\0';
+    ESP_LOGI(TAG, "capture: %s", line);
+  }
+  ESP_LOGI(TAG, "[%s] Capture end", this->parent()->address_str());
+}
 
-  // Wheel events
-  if (raw == 0x4000) {
-    emit("rotate_right", -1, raw_hex);
-    return;
+void BLEClientHID::save_adaptive_window() {
+  const uint32_t window_ms = this->pipeline.gestures().adaptive().window_ms();
+  DBG_LOGI("Adaptive multi-press window now %ums", (unsigned) window_ms);
+  // Written to flash on the preferences flush interval, not on every change.
+  AdaptiveGapBlob blob;
+  this->pipeline.gestures().adaptive().store(blob);
+  this->prefs->adaptive.save(&blob);
+  if (this->multi_press_window_sensor != nullptr)
+    this->multi_press_window_sensor->publish_state(window_ms);
+}
+
+void BLEClientHID::publish_notify_stats() {
+  const uint32_t overflows = this->notify_queue.overflows();
+  if (overflows != this->notify_stats.reported_overflows) {
+    ESP_LOGW(TAG, "[%s] Notify queue overflow: %u record(s) dropped", this->parent()->address_str(),
+             (unsigned) (overflows - this->notify_stats.reported_overflows));
+    this->notify_stats.reported_overflows = overflows;
+  }
+
+  if (this->notify_stats.records > 0) {
+    ESP_LOGD(TAG, "[%s] Notify queue: max depth=%u latency mean=%uus max=%uus (%u records)",
+             this->parent()->address_str(), (unsigned) this->notify_stats.max_depth,
+             (unsigned) this->notify_stats.mean_latency_us(), (unsigned) this->notify_stats.max_latency_us,
+             (unsigned) this->notify_stats.records);
   }
-  if (raw == 0x8000) {
-    emit("rotate_left", -1, raw_hex);
+
+  if (this->notify_queue_depth_sensor != nullptr) {
+    this->notify_queue_depth_sensor->publish_state((float) this->notify_stats.max_depth);
+  }
+  if (this->notify_latency_sensor != nullptr) {
+    this->notify_latency_sensor->publish_state((float) this->notify_stats.max_latency_us);
+  }
+  if (this->notify_overflows_sensor != nullptr) {
+    this->notify_overflows_sensor->publish_state((float) overflows);
+  }
+
+  this->notify_stats.reset_window();
+}
+
+// -----------------------------------------------------------------------------
+// Wheel number seeding from Home Assistant (applied when the remote connects)
+// -----------------------------------------------------------------------------
+void BLEClientHID::on_wheel_seed_state(std::string state) {
+  char *end = nullptr;
+  const float value = strtof(state.c_str(), &end);
+  if (end == state.c_str() || std::isnan(value)) {
+    // unavailable / unknown / off: keep the last usable value
     return;
   }
+  this->wheel_seed_value = value;
+  this->apply_wheel_seed();
+}
 
-  auto &inst = btn_state_by_instance[this];
+void BLEClientHID::apply_wheel_seed() {
+  if (!this->wheel_seed_pending || this->wheel_number == nullptr || std::isnan(this->wheel_seed_value))
+    return;
+  this->wheel_seed_pending = false;
+  this->wheel_number->seed(this->wheel_seed_value);
+  ESP_LOGD(TAG, "[%s] Wheel number seeded to %.2f", this->parent()->address_str(), this->wheel_seed_value);
+}
+
+// -----------------------------------------------------------------------------
+// Registration helpers for sensors/text sensors (used by ESPHome YAML platforms)
+// -----------------------------------------------------------------------------
+void BLEClientHID::register_last_event_value_sensor(sensor::Sensor *last_event_value_sensor) {
+  this->last_event_value_sensor = last_event_value_sensor;
+}
 
-  // Press (non-zero)
-  ButtonId press_btn = raw_to_button_press(raw);
-  if (press_btn != ButtonId::NONE) {
-    inst.active_button = press_btn;
-    auto &st = inst.st[(uint8_t) press_btn];
-    st.is_down = true;
-    st.long_fired = false;
+void BLEClientHID::register_battery_sensor(sensor::Sensor *battery_sensor) { this->battery_sensor = battery_sensor; }
 
-    this->cancel_timeout(std::string("final_") + button_name(press_btn));
-    emit(std::string(button_name(press_btn)) + "_pressed", -1, raw_hex);
+void BLEClientHID::set_button_config(uint8_t button, bool multi_press, uint32_t multi_press_gap_ms,
+                                     uint32_t long_press_ms, bool speculative_single) {
+  if (button >= MAX_BUTTONS)
+    return;
+  auto &cfg = this->pipeline.gestures().config((ButtonId) button);
+  cfg.multi_press = multi_press;
+  cfg.multi_press_gap_ms = multi_press_gap_ms;
+  cfg.long_press_ms = long_press_ms;
+  cfg.speculative_single = speculative_single;
+}
 
-    const std::string long_key = std::string("long_") + button_name(press_btn);
-    this->cancel_timeout(long_key);
+void BLEClientHID::set_button_repeat(uint8_t button, uint32_t delay_ms, uint32_t interval_ms,
+                                     uint32_t min_interval_ms, uint16_t ramp_q8) {
+  if (button >= MAX_BUTTONS)
+    return;
+  auto &cfg = this->pipeline.gestures().config((ButtonId) button);
+  cfg.repeat = true;
+  cfg.repeat_delay_ms = delay_ms;
+  cfg.repeat_interval_ms = interval_ms;
+  cfg.repeat_min_interval_ms = min_interval_ms;
+  cfg.repeat_ramp_q8 = ramp_q8;
+}
 
-    this->set_timeout(long_key, LONG_PRESS_MS, [this, press_btn]() {
-      auto &inst2 = btn_state_by_instance[this];
-      auto &st2 = inst2.st[(uint8_t) press_btn];
-      if (st2.is_down && !st2.long_fired) {
-        st2.long_fired = true;
-        st2.click_count = 0;
+void BLEClientHID::set_profile(const RemoteProfile *profile) {
+  this->profile = profile;
+  this->pipeline.set_profile(profile);
+}
 
-        const char *remote = this->parent()->address_str();
-        const std::string source = esphome::App.get_name();
-        std::string action = std::string(button_name(press_btn)) + "_long";
+void BLEClientHID::set_gestures(const GestureTable *table) {
+  this->gestures_table = table;
+  this->pipeline.set_gestures(table);
+}
 
-#ifdef USE_API
-        std::map<std::string, std::string> data;
-        data["action"] = action;
-        data["raw"] = "";
-        data["clicks"] = "-1";
-        data["remote"] = remote ? remote : "";
-        data["source"] = source;
-        this->fire_homeassistant_event("esphome.remote_action", data);
+void BLEClientHID::add_pool_remote(uint64_t mac) {
+  if (!this->scheduler.add_remote(mac))
+    ESP_LOGW(TAG, "Remote pool full or duplicate address, one remote ignored (max %u)", (unsigned) MAX_POOL_REMOTES);
+}
+
+void BLEClientHID::set_idle_release(uint32_t idle_release_ms) { this->scheduler.set_idle_release_ms(idle_release_ms); }
+
+#ifdef USE_ESP32_BLE_DEVICE
+bool PoolListener::parse_device(const espbt::ESPBTDevice &device) { return this->parent_->on_advertisement(device); }
 #endif
 
-        if (this->last_event_usage_text_sensor != nullptr) {
-          this->last_event_usage_text_sensor->publish_state(action);
-        }
-        ESP_LOGI(TAG, "Remote action: %s remote=%s source=%s raw= clicks=-1", action.c_str(), remote ? remote : "",
-                 source.c_str());
-      }
-    });
+bool BLEClientHID::on_advertisement(const espbt::ESPBTDevice &device) {
+  const bool slot_free = this->parent()->enabled && this->parent()->state() == espbt::ClientState::IDLE;
+  const int8_t index = this->scheduler.on_advertisement(device.address_uint64(), slot_free, esphome::millis());
+  if (index == POOL_NONE)
+    return false;
+  if (this->scheduler.remote(index).mac != this->parent()->get_address())
+    this->retarget_remote(device);
+  // The BLE client sees the same advertisement next and connects.
+  return true;
+}
+
+void BLEClientHID::set_conn_params(uint16_t active_min_interval, uint16_t active_max_interval,
+                                   uint16_t idle_min_interval, uint16_t idle_max_interval, uint16_t idle_latency,
+                                   uint16_t timeout, uint32_t idle_after_ms) {
+  this->conn_policy.configure(LinkParams{active_min_interval, active_max_interval, 0, timeout},
+                              LinkParams{idle_min_interval, idle_max_interval, idle_latency, timeout}, idle_after_ms);
+}
 
+void BLEClientHID::request_conn_params(LinkProfile profile) {
+  const LinkParams &link = this->conn_policy.params(profile);
+  auto &p = this->preferred_conn_params;
+  memcpy(p.bda, this->parent()->get_remote_bda(), sizeof(esp_bd_addr_t));
+  p.min_int = link.min_interval;
+  p.max_int = link.max_interval;
+  p.latency = link.latency;
+  p.timeout = link.timeout;
+  esp_err_t r = esp_ble_gap_update_conn_params(&p);
+  if (r != ESP_OK) {
+    ESP_LOGW(TAG, "[%s] Connection parameter request failed, err=%d", this->parent()->address_str(), (int) r);
+    this->conn_policy.on_request_failed();
     return;
   }
+  DBG_LOGI("Requesting %s link: interval %u..%u x 1.25ms, latency %u", profile == LinkProfile::IDLE ? "idle" : "active",
+           link.min_interval, link.max_interval, link.latency);
+  this->hid_state = HIDState::CONN_PARAMS_UPDATING;
+}
 
-  // Release (0x0000)
-  if (raw == 0x0000) {
-    if (inst.active_button == ButtonId::NONE)
-      return;
+void BLEClientHID::set_scan_duty(uint32_t burst_ms, uint32_t burst_interval_ms, uint32_t burst_window_ms,
+                                 uint32_t idle_interval_ms, uint32_t idle_window_ms) {
+  scan_duty.configure(burst_ms, ScanParams{burst_interval_ms, burst_window_ms},
+                      ScanParams{idle_interval_ms, idle_window_ms});
+}
 
-    ButtonId rb = inst.active_button;
-    inst.active_button = ButtonId::NONE;
+void BLEClientHID::apply_scan_duty(uint32_t now) {
+  ScanParams params;
+  if (!scan_duty.update(now, params))
+    return;
+  DBG_LOGI("Scan duty: interval %ums window %ums", (unsigned) params.interval_ms, (unsigned) params.window_ms);
+  auto *tracker = espbt::global_esp32_ble_tracker;
+  // Tracker units are 0.625 ms.
+  tracker->set_scan_interval(params.interval_ms * 8 / 5);
+  tracker->set_scan_window(params.window_ms * 8 / 5);
+  // Restart the scan so the new duty applies now, not when the scan period ends.
+  tracker->stop_scan();
+}
 
-    auto &st = inst.st[(uint8_t) rb];
-    st.is_down = false;
+// Points the free slot at another pooled remote and swaps in its state.
+void BLEClientHID::retarget_remote(const espbt::ESPBTDevice &device) {
+  this->parent()->set_address(device.address_uint64());
+  this->parent()->set_remote_addr_type(device.get_address_type());
+  ESP_LOGI(TAG, "Connection slot now serves %s", this->parent()->address_str());
+#if BLE_HID_NOTIFY_HOOK
+  this->notify_address.store(device.address_uint64(), std::memory_order_relaxed);
+#endif
+  this->ble_state = RemoteBleState{};
+  this->handle_cache_loaded = false;
+  this->pipeline.reset();
+  this->select_remote_prefs(device.address_uint64());
+  this->load_remote_prefs();
+}
 
-    emit(std::string(button_name(rb)) + "_released", -1, raw_hex);
+void BLEClientHID::add_mode(const char *name) {
+  if (!this->modes.add_mode(name))
+    ESP_LOGW(TAG, "Too many modes, '%s' ignored (max %u)", name, (unsigned) MAX_MODES);
+}
 
-    if (st.long_fired) {
-      st.long_fired = false;
-      st.click_count = 0;
-      return;
-    }
+void BLEClientHID::set_capture(size_t capacity, const std::string &service) {
+  this->capture.set_capacity(capacity);
+  this->capture_service = service;
+}
 
-    if (st.click_count < 3)
-      st.click_count++;
+void BLEClientHID::set_mode_actions(const char *next, const char *previous) {
+  this->modes.set_switch_actions(next, previous);
+}
 
-    const std::string final_key = std::string("final_") + button_name(rb);
-    this->cancel_timeout(final_key);
+void BLEClientHID::set_adaptive_multi_press(uint32_t min_gap_ms, uint32_t max_gap_ms, uint8_t percentile,
+                                            uint32_t margin_ms) {
+  this->pipeline.gestures().adaptive().configure(min_gap_ms, max_gap_ms, percentile, margin_ms);
+}
 
-    this->set_timeout(final_key, MULTIPRESS_GAP_MS, [this, rb]() {
-      auto &inst2 = btn_state_by_instance[this];
-      auto &st2 = inst2.st[(uint8_t) rb];
+void BLEClientHID::set_wheel_coalesce_window(uint32_t window_ms) { this->pipeline.wheel().set_window_ms(window_ms); }
 
-      if (st2.is_down || st2.long_fired || st2.click_count == 0)
-        return;
+void BLEClientHID::set_wheel_acceleration(WheelCurve curve, uint32_t min_speed, uint32_t max_speed,
+                                          uint32_t max_factor_q8, uint8_t exponent, uint32_t velocity_window_ms) {
+  auto &accel = this->pipeline.wheel().acceleration();
+  accel.set_curve(curve);
+  accel.set_speed_range(min_speed, max_speed);
+  accel.set_max_factor(max_factor_q8);
+  accel.set_exponent(exponent);
+  this->pipeline.wheel().velocity().set_window_us(velocity_window_ms * 1000);
+}
 
-      std::string action;
-      if (st2.click_count == 1)
-        action = std::string(button_name(rb)) + "_single";
-      else if (st2.click_count == 2)
-        action = std::string(button_name(rb)) + "_double";
-      else
-        action = std::string(button_name(rb)) + "_triple";
+void BLEClientHID::add_wheel_acceleration_point(uint32_t speed, uint32_t factor_q8) {
+  this->pipeline.wheel().acceleration().add_point(speed, factor_q8);
+}
 
-      const char *remote = this->parent()->address_str();
-      const std::string source = esphome::App.get_name();
+void BLEClientHID::register_wheel_number(WheelNumber *wheel_number) { this->wheel_number = wheel_number; }
 
-#ifdef USE_API
-      std::map<std::string, std::string> data;
-      data["action"] = action;
-      data["raw"] = "";
-      data["clicks"] = std::to_string(st2.click_count);
-      data["remote"] = remote ? remote : "";
-      data["source"] = source;
-      this->fire_homeassistant_event("esphome.remote_action", data);
-#endif
+void BLEClientHID::register_notify_queue_depth_sensor(sensor::Sensor *notify_queue_depth_sensor) {
+  this->notify_queue_depth_sensor = notify_queue_depth_sensor;
+}
 
-      if (this->last_event_usage_text_sensor != nullptr) {
-        this->last_event_usage_text_sensor->publish_state(action);
-      }
-      ESP_LOGI(TAG, "Remote action: %s remote=%s source=%s raw= clicks=%d", action.c_str(), remote ? remote : "",
-               source.c_str(), st2.click_count);
+void BLEClientHID::register_notify_latency_sensor(sensor::Sensor *notify_latency_sensor) {
+  this->notify_latency_sensor = notify_latency_sensor;
+}
 
-      st2.click_count = 0;
-    });
+void BLEClientHID::register_notify_overflows_sensor(sensor::Sensor *notify_overflows_sensor) {
+  this->notify_overflows_sensor = notify_overflows_sensor;
+}
 
-    return;
-  }
+void BLEClientHID::register_multi_press_window_sensor(sensor::Sensor *multi_press_window_sensor) {
+  this->multi_press_window_sensor = multi_press_window_sensor;
+}
 
-  // Unknown raw - still emit for visibility
-  emit(std::string("raw_") + raw_hex, -1, raw_hex);
+void BLEClientHID::register_connection_interval_sensor(sensor::Sensor *connection_interval_sensor) {
+  this->connection_interval_sensor = connection_interval_sensor;
 }
 
-// -----------------------------------------------------------------------------
-// Registration helpers for sensors/text sensors (used by ESPHome YAML platforms)
-// -----------------------------------------------------------------------------
-void BLEClientHID::register_last_event_value_sensor(sensor::Sensor *last_event_value_sensor) {
-  this->last_event_value_sensor = last_event_value_sensor;
+void BLEClientHID::register_wake_latency_sensor(sensor::Sensor *wake_latency_sensor) {
+  this->wake_latency_sensor = wake_latency_sensor;
 }
 
-void BLEClientHID::register_battery_sensor(sensor::Sensor *battery_sensor) { this->battery_sensor = battery_sensor; }
+void BLEClientHID::register_mode_text_sensor(text_sensor::TextSensor *mode_text_sensor) {
+  this->mode_text_sensor = mode_text_sensor;
+}
 
 void BLEClientHID::register_last_event_usage_text_sensor(text_sensor::TextSensor *last_event_usage_text_sensor) {
   this->last_event_usage_text_sensor = last_event_usage_text_sensor;
 }
 
 // -----------------------------------------------------------------------------
-// Unused API hooks (kept for compatibility with existing header / component)
+// Setup reads (Device Information, Battery, HID) through the read queue
 // -----------------------------------------------------------------------------
-void BLEClientHID::schedule_read_char(ble_client::BLECharacteristic *characteristic) { (void) characteristic; }
+struct SetupRead {
+  uint16_t service;
+  uint16_t characteristic;
+};
+
+static const SetupRead SETUP_READS[] = {
+    {0x180A, 0x2A50},  // Device Information: PnP ID
+    {0x180F, 0x2A19},  // Battery: Battery Level
+    {0x1812, 0x2A4A},  // HID: HID Information
+    {0x1812, 0x2A4B},  // HID: Report Map
+};
+
+void BLEClientHID::read_client_characteristics() {
+  uint8_t scheduled = 0;
+  for (const auto &sr : SETUP_READS) {
+    auto *chr = this->parent()->get_characteristic(sr.service, sr.characteristic);
+    if (chr == nullptr) {
+      DBG_LOGI("Characteristic 0x%04x not found in service 0x%04x", sr.characteristic, sr.service);
+      continue;
+    }
+    if (sr.characteristic == 0x2A19)
+      this->battery_handle = chr->handle;
+    this->schedule_read_char(chr, sr.characteristic);
+    scheduled++;
+  }
+
+  this->hid_state = HIDState::READING_CHARS;
+  ESP_LOGD(TAG, "[%s] Reading %u characteristic(s)", this->parent()->address_str(), scheduled);
+  this->read_queue.loop(esphome::millis());
+}
+
+void BLEClientHID::schedule_read_char(ble_client::BLECharacteristic *characteristic, uint16_t uuid) {
+  if (!this->read_queue.enqueue(characteristic->handle, uuid,
+                                [this](const GATTReadData &data) { this->on_gatt_read_finished(data); })) {
+    ESP_LOGW(TAG, "Read queue full, dropping read of 0x%04x (handle=%u)", uuid, characteristic->handle);
+  }
+}
+
+void BLEClientHID::on_gatt_read_finished(const GATTReadData &data) {
+  if (!data.ok()) {
+    ESP_LOGW(TAG, "[%s] Read of 0x%04x (handle=%u) failed: status=%d", this->parent()->address_str(), data.uuid_,
+             data.handle_, data.status_);
+    return;
+  }
+  if (data.truncated_) {
+    ESP_LOGW(TAG, "Read of 0x%04x truncated to %u bytes", data.uuid_, data.value_len_);
+  }
+
+  switch (data.uuid_) {
+    case 0x2A50: {
+      // PnP ID: vendor id source, vendor id, product id, product version (LE).
+      if (data.value_len_ < 7)
+        break;
+      this->vendor_id = (uint16_t) data.value_[1] | ((uint16_t) data.value_[2] << 8);
+      this->product_id = (uint16_t) data.value_[3] | ((uint16_t) data.value_[4] << 8);
+      this->version = (uint16_t) data.value_[5] | ((uint16_t) data.value_[6] << 8);
+      break;
+    }
+    case 0x2A19: {
+      if (data.value_len_ < 1)
+        break;
+      if (this->battery_sensor != nullptr) {
+        this->battery_sensor->publish_state((float) data.value_[0]);
+      }
+      break;
+    }
+    case 0x2A4A: {
+      // HID Information: bcdHID, bCountryCode, flags.
+      if (data.value_len_ < 4)
+        break;
+      this->hid_version = (uint16_t) data.value_[0] | ((uint16_t) data.value_[1] << 8);
+      this->hid_flags = data.value_[3];
+      break;
+    }
+    case 0x2A4B: {
+      delete this->hid_report_map;
+      this->hid_report_map = HIDReportMap::parse_report_map_data(data.value_, data.value_len_);
+      if (this->hid_report_map == nullptr) {
+        ESP_LOGW(TAG, "[%s] Failed to parse report map (%u bytes)", this->parent()->address_str(), data.value_len_);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
 
 uint8_t *BLEClientHID::parse_characteristic_data(ble_client::BLEService *service, uint16_t uuid) {
   (void) service;
@@ -821,7 +1206,10 @@ uint8_t *BLEClientHID::parse_characteristic_data(ble_client::BLEService *service
 }
 
 void BLEClientHID::configure_hid_client() {
-  // Not needed (handle-based / discovery-based).
+  // Notifications are handle/discovery based (see above); this only records what the reads found.
+  this->hid_state = HIDState::CONFIGURED;
+  ESP_LOGI(TAG, "[%s] HID client configured: vendor=0x%04x product=0x%04x version=0x%04x hid=0x%04x",
+           this->parent()->address_str(), this->vendor_id, this->product_id, this->version, this->hid_version);
 }
 
 }  // namespace ble_client_hid
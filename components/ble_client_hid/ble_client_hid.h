@@ -1,5 +1,7 @@
-#include <map>
+#include <atomic>
+#include <cmath>
 #include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
 #include "esphome/components/ble_client/ble_client.h"
 #include "esphome/components/esp32_ble_tracker/esp32_ble_tracker.h"
 #include "esphome/components/sensor/sensor.h"
@@ -7,7 +9,25 @@
 #ifdef USE_API
 #include "esphome/components/api/custom_api_device.h"
 #endif
+#include "capture.h"
+#include "conn_params.h"
+#include "connection_scheduler.h"
+#include "event_data.h"
+#include "event_pipeline.h"
+#include "gatt_read_queue.h"
+#include "gesture.h"
+#include "gestures_essence.h"
 #include "hid_parser.h"
+#include "mode.h"
+#include "notify_pairs.h"
+#include "notify_queue.h"
+#include "profile.h"
+#include "profile_essence.h"
+#include "remote_event.h"
+#include "scan_duty.h"
+#include "subscription.h"
+#include "wheel.h"
+#include "wheel_number.h"
 
 #ifdef USE_ESP32
 
@@ -43,22 +63,28 @@ enum class HIDState {
   
 };
 
-class GATTReadData {
-  public:
-    GATTReadData(uint16_t handle, uint8_t *value, uint16_t value_len){
-      this->handle_ = handle;
-      this->value_len_ = value_len;
-      this->value_ = new uint8_t[value_len];
-      memcpy(this->value_, value, sizeof(uint8_t) * value_len);
-    }
-    ~GATTReadData(){
-      delete value_;
-    }
-  public:
-    uint8_t *value_;
-    uint16_t value_len_;
-    uint16_t handle_;
+class BLEClientHID;
+
+// Preference objects of one remote. Made once in setup() and kept: ESPHome
+// cannot release one, so retargeting the slot only switches between them.
+struct RemotePrefs {
+  uint64_t mac{0};
+  ESPPreferenceObject handle_cache;
+  ESPPreferenceObject adaptive;
+  ESPPreferenceObject mode;
+};
+
+#ifdef USE_ESP32_BLE_DEVICE
+// Hands advertisements to the component's connection scheduler.
+class PoolListener : public espbt::ESPBTDeviceListener {
+ public:
+  explicit PoolListener(BLEClientHID *parent) : parent_(parent) {}
+  bool parse_device(const espbt::ESPBTDevice &device) override;
+
+ protected:
+  BLEClientHID *parent_;
 };
+#endif
 
 #ifdef USE_API
 class BLEClientHID : public Component, public api::CustomAPIDevice, public ble_client::BLEClientNode {
@@ -66,37 +92,127 @@ class BLEClientHID : public Component, public api::CustomAPIDevice, public ble_c
 class BLEClientHID : public Component, public ble_client::BLEClientNode {
 #endif
  public:
+  void setup() override;
   void loop() override;
   void gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if,
                            esp_ble_gattc_cb_param_t *param) override;
 
   void dump_config() override;
-  void schedule_read_char(ble_client::BLECharacteristic *characteristic);
-  void on_gatt_read_finished(GATTReadData *data);
+  void schedule_read_char(ble_client::BLECharacteristic *characteristic, uint16_t uuid);
+  void on_gatt_read_finished(const GATTReadData &data);
   void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param) override;
   void read_client_characteristics();
   float get_setup_priority() const override { return setup_priority::AFTER_BLUETOOTH; }
   void register_last_event_usage_text_sensor(text_sensor::TextSensor *last_event_usage_text_sensor);
   void register_last_event_value_sensor(sensor::Sensor *last_event_value_sensor);
   void register_battery_sensor(sensor::Sensor * battery_sensor);
+  void register_wheel_number(WheelNumber *wheel_number);
+  void register_notify_queue_depth_sensor(sensor::Sensor *notify_queue_depth_sensor);
+  void register_notify_latency_sensor(sensor::Sensor *notify_latency_sensor);
+  void register_notify_overflows_sensor(sensor::Sensor *notify_overflows_sensor);
+  void register_multi_press_window_sensor(sensor::Sensor *multi_press_window_sensor);
+  void register_mode_text_sensor(text_sensor::TextSensor *mode_text_sensor);
+  void register_wake_latency_sensor(sensor::Sensor *wake_latency_sensor);
+  void register_connection_interval_sensor(sensor::Sensor *connection_interval_sensor);
   void configure_hid_client();
+  void set_button_config(uint8_t button, bool multi_press, uint32_t multi_press_gap_ms, uint32_t long_press_ms,
+                         bool speculative_single);
+  void set_button_repeat(uint8_t button, uint32_t delay_ms, uint32_t interval_ms, uint32_t min_interval_ms,
+                         uint16_t ramp_q8);
+  void set_profile(const RemoteProfile *profile);
+  void set_gestures(const GestureTable *table);
+  void add_pool_remote(uint64_t mac);
+  void set_idle_release(uint32_t idle_release_ms);
+  void set_conn_params(uint16_t active_min_interval, uint16_t active_max_interval, uint16_t idle_min_interval,
+                       uint16_t idle_max_interval, uint16_t idle_latency, uint16_t timeout, uint32_t idle_after_ms);
+  void set_scan_duty(uint32_t burst_ms, uint32_t burst_interval_ms, uint32_t burst_window_ms,
+                     uint32_t idle_interval_ms, uint32_t idle_window_ms);
+  // Advertisement seen by the tracker; retargets the free slot to a pooled remote.
+  bool on_advertisement(const espbt::ESPBTDevice &device);
+  void add_mode(const char *name);
+  // Keep the last `capacity` notifications; `service` dumps them to the log.
+  void set_capture(size_t capacity, const std::string &service);
+  void set_mode_actions(const char *next, const char *previous);
+  void set_adaptive_multi_press(uint32_t min_gap_ms, uint32_t max_gap_ms, uint8_t percentile, uint32_t margin_ms);
+  void set_wheel_coalesce_window(uint32_t window_ms);
+  void set_wheel_acceleration(WheelCurve curve, uint32_t min_speed, uint32_t max_speed, uint32_t max_factor_q8,
+                              uint8_t exponent, uint32_t velocity_window_ms);
+  void add_wheel_acceleration_point(uint32_t speed, uint32_t factor_q8);
   
  protected:
-  void send_input_report_event(esp_ble_gattc_cb_param_t *p_data);
+  void publish_notify_stats();
+  void save_adaptive_window();
+  void switch_mode();
+  void dump_capture();
+  void make_remote_prefs(uint64_t mac);
+  void select_remote_prefs(uint64_t mac);
+  void load_remote_prefs();
+  void retarget_remote(const espbt::ESPBTDevice &device);
+  void apply_scan_duty(uint32_t now);
+  void request_conn_params(LinkProfile profile);
+  // BLE_HID_NOTIFY_HOOK only.
+  void install_notify_hook();
+  static void notify_hook(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if, esp_ble_gattc_cb_param_t *param);
+  bool enqueue_notify(esp_gatt_if_t gattc_if, const esp_ble_gattc_cb_param_t *param, uint32_t t_us);
+  bool is_own_notify(esp_gatt_if_t gattc_if, const esp_ble_gattc_cb_param_t *param) const;
+  void load_cached_pairs();
+  void save_cached_pairs();
+  void discover_notify_pairs(const char *reason);
+  void on_wheel_seed_state(std::string state);
+  void apply_wheel_seed();
+  void emit_event(const RemoteEvent &event);
   uint8_t *parse_characteristic_data(ble_client::BLEService *service, uint16_t uuid);
-  HIDReportMap* hid_report_map;
-  std::vector<ble_client::BLECharacteristic *> characteristics;
-  std::vector<uint16_t> handles_registered_for_notify;
-  std::map<uint16_t, GATTReadData *> handles_to_read;
-  std::map<uint16_t, uint8_t> handle_report_id;
+  HIDReportMap* hid_report_map = nullptr;
+  GATTReadQueue read_queue;
+  RemoteBleState ble_state;
+  NotifySubscriber subscriber;
+  HandleCacheBlob handle_cache_blob;
+  bool handle_cache_loaded = false;
+  // One per pooled remote, plus the boot address if the pool had no room for it.
+  RemotePrefs remote_prefs[MAX_POOL_REMOTES + 1];
+  uint8_t remote_prefs_count = 0;
+  RemotePrefs *prefs = &remote_prefs[0];  // the remote the slot serves
   text_sensor::TextSensor *last_event_usage_text_sensor = nullptr;
+  text_sensor::TextSensor *mode_text_sensor = nullptr;
   sensor::Sensor *last_event_value_sensor = nullptr;
   sensor::Sensor *battery_sensor = nullptr;
+  sensor::Sensor *notify_queue_depth_sensor = nullptr;
+  sensor::Sensor *notify_latency_sensor = nullptr;
+  sensor::Sensor *notify_overflows_sensor = nullptr;
+  sensor::Sensor *multi_press_window_sensor = nullptr;
+  sensor::Sensor *wake_latency_sensor = nullptr;
+  sensor::Sensor *connection_interval_sensor = nullptr;
+  NotifyQueue notify_queue;
+  // BLE_HID_NOTIFY_HOOK: written in loop(), read by notify_hook() on the Bluedroid task.
+  std::atomic<uint64_t> notify_address{0};
+  std::atomic<esp_gatt_if_t> notify_gattc_if{ESP_GATT_IF_NONE};
+  // Notifications notify_hook() queued, and how many of them loop() has seen.
+  std::atomic<uint32_t> hook_notifies{0};
+  uint32_t loop_notifies = 0;
+  NotifyStats notify_stats;
+  CaptureRing capture;
+  std::string capture_service;
+  const RemoteProfile *profile = &PROFILE_ESSENCE;
+  const GestureTable *gestures_table = &GESTURES_ESSENCE;
+  EventPipeline pipeline;
+  ModeLayer modes;
+  ConnectionScheduler scheduler;
+  bool releasing_idle = false;  // the next disconnect is our own idle release
+  ConnParamPolicy conn_policy;
+#ifdef USE_ESP32_BLE_DEVICE
+  PoolListener pool_listener{this};
+#endif
+  WheelNumber *wheel_number = nullptr;
+  float wheel_seed_value = NAN;
+  bool wheel_seed_pending = false;
+  uint32_t last_stats_publish_ms = 0;
   HIDState hid_state = HIDState::INIT;
-  uint16_t battery_handle;
-  uint16_t vendor_id;
-  uint16_t product_id;
-  uint16_t version;
+  uint16_t battery_handle = 0;
+  uint16_t vendor_id = 0;
+  uint16_t product_id = 0;
+  uint16_t version = 0;
+  uint16_t hid_version = 0;
+  uint8_t hid_flags = 0;
   std::string device_name;
   std::string manufacturer;
   std::string serial_number;
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "notify_queue.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+// -----------------------------------------------------------------------------
+// Notification capture file, all integers little endian:
+//
+//   header  "HIDC", version (2), profile name length (1), profile name,
+//           gesture table states (2), remote count, remote MACs (6 bytes each, as printed)
+//   record  t_us (4), remote index (1), handle (2), payload length (1), payload
+//
+// Written from the device's capture ring, read back by host/replay_hid, which
+// decodes with the profile and gesture table named in the header.
+// -----------------------------------------------------------------------------
+static constexpr uint8_t CAPTURE_VERSION = 2;
+static constexpr uint8_t CAPTURE_PROFILE_NAME_MAX = 31;
+static constexpr uint8_t CAPTURE_MAX_REMOTES = 8;
+static constexpr uint8_t CAPTURE_REMOTE_OTHER = 0xFF;  // remote table full
+static constexpr size_t CAPTURE_RECORD_HEADER_SIZE = 8;
+
+struct CaptureRecord {
+  uint32_t t_us{0};  // arrival time (micros), as in NotifyRecord
+  uint8_t remote{0};
+  uint16_t handle{0};
+  uint8_t len{0};
+  uint8_t data[NOTIFY_PAYLOAD_MAX]{};
+};
+
+// Last `capacity` notifications of a component, oldest overwritten first.
+// Filled from loop() as records are drained, so queue overflows are not in it.
+class CaptureRing {
+ public:
+  // Allocates once, at setup.
+  void set_capacity(size_t capacity) {
+    this->records_.assign(capacity, CaptureRecord{});
+    this->clear();
+  }
+  bool is_enabled() const { return !this->records_.empty(); }
+  size_t capacity() const { return this->records_.size(); }
+  size_t size() const { return this->count_; }
+
+  void add(uint64_t mac, const NotifyRecord &rec) {
+    if (this->records_.empty())
+      return;
+    CaptureRecord &out = this->records_[this->head_];
+    out.t_us = rec.t_us;
+    out.remote = this->remote_index_(mac);
+    out.handle = rec.handle;
+    out.len = rec.len;
+    memcpy(out.data, rec.data, rec.len);
+    this->head_ = (this->head_ + 1) % this->records_.size();
+    if (this->count_ < this->records_.size())
+      this->count_++;
+  }
+  void clear() {
+    this->head_ = 0;
+    this->count_ = 0;
+    this->remote_count_ = 0;
+  }
+
+  // Serialises the capture, oldest record first, as calls of out(data, len).
+  // `profile` and `gesture_states` identify what the records were decoded with.
+  template<typename Out> void write(const char *profile, uint16_t gesture_states, Out &&out) const {
+    uint8_t buf[CAPTURE_RECORD_HEADER_SIZE + NOTIFY_PAYLOAD_MAX];
+    const size_t name_len = strnlen(profile, CAPTURE_PROFILE_NAME_MAX);
+    buf[0] = 'H';
+    buf[1] = 'I';
+    buf[2] = 'D';
+    buf[3] = 'C';
+    buf[4] = CAPTURE_VERSION;
+    buf[5] = (uint8_t) name_len;
+    out(buf, 6);
+    out(reinterpret_cast<const uint8_t *>(profile), name_len);
+    buf[0] = (uint8_t) gesture_states;
+    buf[1] = (uint8_t) (gesture_states >> 8);
+    buf[2] = this->remote_count_;
+    out(buf, 3);
+    for (uint8_t i = 0; i < this->remote_count_; i++) {
+      for (uint8_t b = 0; b < 6; b++)
+        buf[b] = (uint8_t) (this->remotes_[i] >> (8 * (5 - b)));
+      out(buf, 6);
+    }
+    const size_t capacity = this->records_.size();
+    for (size_t i = 0; i < this->count_; i++) {
+      const CaptureRecord &rec = this->records_[(this->head_ + capacity - this->count_ + i) % capacity];
+      buf[0] = (uint8_t) rec.t_us;
+      buf[1] = (uint8_t) (rec.t_us >> 8);
+      buf[2] = (uint8_t) (rec.t_us >> 16);
+      buf[3] = (uint8_t) (rec.t_us >> 24);
+      buf[4] = rec.remote;
+      buf[5] = (uint8_t) rec.handle;
+      buf[6] = (uint8_t) (rec.handle >> 8);
+      buf[7] = rec.len;
+      memcpy(buf + CAPTURE_RECORD_HEADER_SIZE, rec.data, rec.len);
+      out(buf, CAPTURE_RECORD_HEADER_SIZE + rec.len);
+    }
+  }
+
+ protected:
+  uint8_t remote_index_(uint64_t mac) {
+    for (uint8_t i = 0; i < this->remote_count_; i++) {
+      if (this->remotes_[i] == mac)
+        return i;
+    }
+    if (this->remote_count_ >= CAPTURE_MAX_REMOTES)
+      return CAPTURE_REMOTE_OTHER;
+    this->remotes_[this->remote_count_] = mac;
+    return this->remote_count_++;
+  }
+
+  std::vector<CaptureRecord> records_;
+  size_t head_{0};
+  size_t count_{0};
+  uint64_t remotes_[CAPTURE_MAX_REMOTES]{};
+  uint8_t remote_count_{0};
+};
+
+// Reads a capture written by CaptureRing::write from memory.
+class CaptureReader {
+ public:
+  // Parses the header; false if `data` is not a capture of this version.
+  bool open(const uint8_t *data, size_t len) {
+    this->data_ = data;
+    this->len_ = len;
+    if (len < 6 || memcmp(data, "HIDC", 4) != 0 || data[4] != CAPTURE_VERSION)
+      return false;
+    const uint8_t name_len = data[5] < CAPTURE_PROFILE_NAME_MAX ? data[5] : CAPTURE_PROFILE_NAME_MAX;
+    if (6 + (size_t) data[5] + 3 > len)
+      return false;
+    memcpy(this->profile_, data + 6, name_len);
+    this->profile_[name_len] = '\0';
+    this->pos_ = 6 + data[5];
+    this->gesture_states_ = (uint16_t) (data[this->pos_] | (data[this->pos_ + 1] << 8));
+    const uint8_t remotes = data[this->pos_ + 2];
+    this->remote_count_ = remotes < CAPTURE_MAX_REMOTES ? remotes : CAPTURE_MAX_REMOTES;
+    this->pos_ += 3;
+    for (uint8_t i = 0; i < this->remote_count_; i++) {
+      if (this->pos_ + 6 > len)
+        return false;
+      uint64_t mac = 0;
+      for (uint8_t b = 0; b < 6; b++)
+        mac = (mac << 8) | data[this->pos_ + b];
+      this->remotes_[i] = mac;
+      this->pos_ += 6;
+    }
+    return true;
+  }
+  const char *profile() const { return this->profile_; }
+  uint16_t gesture_states() const { return this->gesture_states_; }
+  uint8_t remote_count() const { return this->remote_count_; }
+  uint64_t remote(uint8_t index) const { return index < this->remote_count_ ? this->remotes_[index] : 0; }
+
+  // Next record; false at the end or on a truncated one. Longer payloads are cut
+  // to NOTIFY_PAYLOAD_MAX, as the device queue does.
+  bool next(CaptureRecord &out) {
+    if (this->pos_ + CAPTURE_RECORD_HEADER_SIZE > this->len_)
+      return false;
+    const uint8_t *p = this->data_ + this->pos_;
+    const uint8_t len = p[7];
+    if (this->pos_ + CAPTURE_RECORD_HEADER_SIZE + len > this->len_)
+      return false;
+    out.t_us = (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+    out.remote = p[4];
+    out.handle = (uint16_t) (p[5] | (p[6] << 8));
+    out.len = len < NOTIFY_PAYLOAD_MAX ? len : NOTIFY_PAYLOAD_MAX;
+    memcpy(out.data, p + CAPTURE_RECORD_HEADER_SIZE, out.len);
+    this->pos_ += CAPTURE_RECORD_HEADER_SIZE + len;
+    return true;
+  }
+
+ protected:
+  const uint8_t *data_{nullptr};
+  size_t len_{0};
+  size_t pos_{0};
+  char profile_[CAPTURE_PROFILE_NAME_MAX + 1]{};
+  uint16_t gesture_states_{0};
+  uint64_t remotes_[CAPTURE_MAX_REMOTES]{};
+  uint8_t remote_count_{0};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
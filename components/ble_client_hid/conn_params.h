@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace ble_client_hid {
+
+// Link parameters in controller units: interval 1.25 ms, timeout 10 ms.
+struct LinkParams {
+  uint16_t min_interval{0};
+  uint16_t max_interval{0};
+  uint16_t latency{0};  // connection events the remote may skip
+  uint16_t timeout{0};
+};
+
+enum class LinkProfile : uint8_t { NONE = 0, ACTIVE, IDLE };
+
+// Don't pile up update requests; one takes a few connection events to apply.
+static constexpr uint32_t CONN_PARAMS_MIN_REQUEST_GAP_MS = 1000;
+// An update the controller has not answered within this many supervision
+// timeouts is taken as lost.
+static constexpr uint32_t CONN_PARAMS_UPDATE_TIMEOUTS = 2;
+
+// -----------------------------------------------------------------------------
+// Connection parameter policy: a short interval with no peripheral latency
+// while the remote is in use, a relaxed one after `idle_after_ms` without
+// input. Decides when to ask; the component sends the request.
+// -----------------------------------------------------------------------------
+class ConnParamPolicy {
+ public:
+  void configure(const LinkParams &active, const LinkParams &idle, uint32_t idle_after_ms) {
+    this->enabled_ = true;
+    this->active_ = active;
+    this->idle_ = idle;
+    this->idle_after_ms_ = idle_after_ms;
+  }
+  bool is_enabled() const { return this->enabled_; }
+  const LinkParams &params(LinkProfile profile) const {
+    return profile == LinkProfile::IDLE ? this->idle_ : this->active_;
+  }
+  uint32_t idle_after_ms() const { return this->idle_after_ms_; }
+  LinkProfile requested() const { return this->requested_; }
+
+  // Input seen; returns true if the fast profile should be requested.
+  bool on_input(uint32_t now_ms) {
+    this->last_input_ms_ = now_ms;
+    return this->want_(LinkProfile::ACTIVE, now_ms);
+  }
+  // Returns true if the link has been quiet long enough to relax it.
+  bool poll(uint32_t now_ms) {
+    if (now_ms - this->last_input_ms_ < this->idle_after_ms_)
+      return false;
+    return this->want_(LinkProfile::IDLE, now_ms);
+  }
+  // The last request was refused, by the stack or the remote. The link keeps
+  // the profile it had; the refused one is not asked for again until the
+  // link wants the other profile in between, or the remote reconnects.
+  void on_request_failed() {
+    this->refused_ = this->requested_;
+    this->requested_ = this->previous_;
+    this->pending_ = false;
+  }
+  // Returns true once if the last request got no answer in time; it is then
+  // treated as refused.
+  bool update_expired(uint32_t now_ms) {
+    if (!this->pending_)
+      return false;
+    uint32_t deadline_ms = this->params(this->requested_).timeout * 10u * CONN_PARAMS_UPDATE_TIMEOUTS;
+    if (deadline_ms < CONN_PARAMS_MIN_REQUEST_GAP_MS)
+      deadline_ms = CONN_PARAMS_MIN_REQUEST_GAP_MS;
+    if (now_ms - this->last_request_ms_ < deadline_ms)
+      return false;
+    this->on_request_failed();
+    return true;
+  }
+
+  // Negotiated interval from the controller (1.25 ms units).
+  void on_updated(uint16_t interval) {
+    this->interval_ = interval;
+    this->pending_ = false;
+  }
+  uint16_t interval() const { return this->interval_; }
+
+  // New connection: the remote just woke, so treat it as in use.
+  void reset(uint32_t now_ms) {
+    this->requested_ = LinkProfile::NONE;
+    this->previous_ = LinkProfile::NONE;
+    this->refused_ = LinkProfile::NONE;
+    this->pending_ = false;
+    this->last_input_ms_ = now_ms;
+    this->last_request_ms_ = now_ms - CONN_PARAMS_MIN_REQUEST_GAP_MS;
+    this->interval_ = 0;
+  }
+
+ protected:
+  bool want_(LinkProfile profile, uint32_t now_ms) {
+    if (!this->enabled_)
+      return false;
+    // Wanting the other profile ends the previous refusal.
+    if (this->refused_ != profile)
+      this->refused_ = LinkProfile::NONE;
+    if (this->requested_ == profile || this->refused_ == profile)
+      return false;
+    if (now_ms - this->last_request_ms_ < CONN_PARAMS_MIN_REQUEST_GAP_MS)
+      return false;
+    this->previous_ = this->requested_;
+    this->requested_ = profile;
+    this->pending_ = true;
+    this->last_request_ms_ = now_ms;
+    return true;
+  }
+
+  bool enabled_{false};
+  LinkParams active_{};
+  LinkParams idle_{};
+  uint32_t idle_after_ms_{0};
+  LinkProfile requested_{LinkProfile::NONE};
+  LinkProfile previous_{LinkProfile::NONE};  // in use before the last request
+  LinkProfile refused_{LinkProfile::NONE};
+  bool pending_{false};  // requested, no answer from the controller yet
+  uint32_t last_input_ms_{0};
+  uint32_t last_request_ms_{0};
+  uint16_t interval_{0};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace ble_client_hid {
+
+static constexpr uint8_t MAX_POOL_REMOTES = 8;
+static constexpr int8_t POOL_NONE = -1;
+
+// Wake-to-first-event statistics of one pooled remote.
+struct PoolRemote {
+  uint64_t mac{0};
+  bool waking{false};  // advertisement seen, no event yet
+  uint32_t wake_ms{0};
+  uint32_t last_latency_ms{0};
+  uint32_t worst_latency_ms{0};
+  uint16_t wakes{0};
+};
+
+// -----------------------------------------------------------------------------
+// Connection scheduler: several remotes share one BLE connection slot. The
+// slot goes to whichever remote advertises while it is free, and is released
+// after a quiet period so the next remote that wakes can have it.
+// -----------------------------------------------------------------------------
+class ConnectionScheduler {
+ public:
+  bool add_remote(uint64_t mac) {
+    if (this->count_ >= MAX_POOL_REMOTES || this->find(mac) != POOL_NONE)
+      return false;
+    this->remotes_[this->count_++].mac = mac;
+    return true;
+  }
+  void set_idle_release_ms(uint32_t idle_release_ms) { this->idle_release_ms_ = idle_release_ms; }
+  uint32_t idle_release_ms() const { return this->idle_release_ms_; }
+
+  // More than one remote shares the slot.
+  bool is_pooled() const { return this->count_ > 1; }
+  uint8_t size() const { return this->count_; }
+  const PoolRemote &remote(uint8_t index) const { return this->remotes_[index]; }
+  int8_t current() const { return this->current_; }
+
+  int8_t find(uint64_t mac) const {
+    for (uint8_t i = 0; i < this->count_; i++) {
+      if (this->remotes_[i].mac == mac)
+        return (int8_t) i;
+    }
+    return POOL_NONE;
+  }
+
+  // Advertisement from `mac` at `now_ms`. Returns the pool index the free slot
+  // should connect to, or POOL_NONE (not ours, or the slot is busy).
+  int8_t on_advertisement(uint64_t mac, bool slot_free, uint32_t now_ms) {
+    const int8_t index = this->find(mac);
+    if (index == POOL_NONE || !slot_free)
+      return POOL_NONE;
+    PoolRemote &r = this->remotes_[index];
+    if (!r.waking) {
+      r.waking = true;
+      r.wake_ms = now_ms;
+    }
+    this->current_ = index;
+    return index;
+  }
+
+  // Input from the connected remote. Returns true for the first one after a
+  // wake, with the wake-to-event latency in `latency_ms`.
+  bool on_activity(uint32_t now_ms, uint32_t &latency_ms) {
+    this->last_activity_ms_ = now_ms;
+    if (this->current_ == POOL_NONE)
+      return false;
+    PoolRemote &r = this->remotes_[this->current_];
+    if (!r.waking)
+      return false;
+    r.waking = false;
+    latency_ms = now_ms - r.wake_ms;
+    r.last_latency_ms = latency_ms;
+    if (latency_ms > r.worst_latency_ms)
+      r.worst_latency_ms = latency_ms;
+    if (r.wakes < UINT16_MAX)
+      r.wakes++;
+    return true;
+  }
+
+  void on_connected(uint32_t now_ms) {
+    this->connected_ = true;
+    this->last_activity_ms_ = now_ms;
+  }
+  void on_disconnected() {
+    this->connected_ = false;
+    // A wake that never produced an event does not count.
+    if (this->current_ != POOL_NONE)
+      this->remotes_[this->current_].waking = false;
+  }
+
+  // The link has been quiet for idle_release_ms and another remote may want the slot.
+  bool should_release(uint32_t now_ms) const {
+    return this->is_pooled() && this->connected_ && this->idle_release_ms_ > 0 &&
+           now_ms - this->last_activity_ms_ >= this->idle_release_ms_;
+  }
+
+ protected:
+  PoolRemote remotes_[MAX_POOL_REMOTES]{};
+  uint8_t count_{0};
+  int8_t current_{POOL_NONE};
+  bool connected_{false};
+  uint32_t last_activity_ms_{0};
+  uint32_t idle_release_ms_{0};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "remote_event.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+// -----------------------------------------------------------------------------
+// Text form of a RemoteEvent, formatted into its own buffers (no allocation).
+// -----------------------------------------------------------------------------
+struct EventText {
+  const char *action{nullptr};
+  const char *raw{""};
+  char clicks[INT_BUF_SIZE]{};
+
+  explicit EventText(const RemoteEvent &event) {
+    this->action = event_action_name(event, this->action_buf_);
+    if (event.has_raw)
+      this->raw = format_hex4(this->raw_buf_, event.raw);
+    format_int(this->clicks, event.clicks);
+  }
+  EventText(const EventText &) = delete;
+  EventText &operator=(const EventText &) = delete;
+
+ protected:
+  char action_buf_[ACTION_NAME_BUF_SIZE]{};
+  char raw_buf_[HEX4_BUF_SIZE]{};
+};
+
+// Data of the esphome.remote_action event. The API takes a std::map; this is
+// where the event path starts to allocate.
+inline std::map<std::string, std::string> event_data(const RemoteEvent &event, const EventText &text,
+                                                     const char *remote, const std::string &source,
+                                                     const char *mode) {
+  std::map<std::string, std::string> data{
+      {"action", text.action}, {"raw", text.raw}, {"clicks", text.clicks}, {"remote", remote ? remote : ""},
+      {"source", source},
+  };
+  char num_buf[INT_BUF_SIZE];
+  if (event.steps > 0) {
+    data.emplace("steps", format_int(num_buf, event.steps));
+    data.emplace("delta", format_int(num_buf, event.delta));
+  }
+  if (event.repeat > 0)
+    data.emplace("repeat", format_int(num_buf, event.repeat));
+  if (event.gesture > 0) {
+    data.emplace("gesture", format_int(num_buf, event.gesture));
+    data.emplace("provisional", event.provisional ? "true" : "false");
+  }
+  if (mode != nullptr)
+    data.emplace("mode", mode);
+  return data;
+}
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,104 @@
+#include "event_pipeline.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+void EventPipeline::feed(const NotifyRecord &record) {
+  this->gestures_.advance(record.t_us);
+  this->decode_(record);
+}
+
+void EventPipeline::poll(uint32_t now_us, uint32_t now_ms) {
+  this->gestures_.advance(now_us);
+  WheelFlush wf;
+  if (this->wheel_.end_batch(now_ms, wf) || this->wheel_.poll(now_ms, wf))
+    this->emit_wheel_(wf);
+}
+
+void EventPipeline::reset() {
+  this->gestures_.reset();
+  this->decoder_.reset();
+  this->wheel_.reset();
+  this->wheel_modifier_ = ButtonId::NONE;
+  this->toggle_state_ = 0;
+}
+
+void EventPipeline::decode_(const NotifyRecord &record) {
+  if (record.len < 2)
+    return;
+
+  const RemoteProfile &profile = *this->profile_;
+  const uint16_t raw = profile.decode_key(record.data);
+
+  ControlEdge edges[MAX_EDGES_PER_REPORT];
+  const uint8_t n = this->decoder_.decode(raw, edges);
+  for (uint8_t i = 0; i < n; i++) {
+    const ControlEdge &edge = edges[i];
+    if (edge.kind == EdgeKind::UNKNOWN) {
+      // Unknown code - still emit for visibility
+      this->emit_(RemoteEvent{nullptr, raw, true, -1});
+      continue;
+    }
+    const ProfileControl &control = profile.controls[edge.control];
+    switch (control.type) {
+      case ControlType::BUTTON:
+        if (edge.kind == EdgeKind::PRESS) {
+          this->gestures_.press((ButtonId) control.index, edge.code, record.t_us);
+        } else if (edge.kind == EdgeKind::RELEASE) {
+          this->gestures_.release((ButtonId) control.index, raw, record.t_us);
+        }
+        break;
+      case ControlType::WHEEL: {
+        // Coalesced, emitted from poll() (or here on a direction change)
+        this->wheel_actions_ = control.actions;
+        this->wheel_codes_[edge.direction > 0 ? 0 : 1] = edge.code;
+        WheelFlush wf;
+        // Turned while a button is held: a chord with that button, kept apart
+        // from plain rotation.
+        const ButtonId modifier = this->gestures_.held_button();
+        if (modifier != this->wheel_modifier_) {
+          if (this->wheel_.flush(wf))
+            this->emit_wheel_(wf);
+          this->wheel_modifier_ = modifier;
+        }
+        if (modifier != ButtonId::NONE)
+          this->wheel_gesture_ = this->gestures_.use_as_modifier(modifier);
+        if (this->wheel_.add_tick(edge.direction, record.t_us, wf)) {
+          this->emit_wheel_(wf);
+        }
+        break;
+      }
+      case ControlType::TOGGLE: {
+        if (edge.kind != EdgeKind::PRESS)
+          break;
+        const uint32_t bit = 1u << control.index;
+        this->toggle_state_ ^= bit;
+        this->emit_(RemoteEvent{control.actions[(this->toggle_state_ & bit) ? 0 : 1], edge.code, true, -1});
+        break;
+      }
+    }
+  }
+}
+
+void EventPipeline::emit_wheel_(const WheelFlush &flush) {
+  RemoteEvent ev;
+  const uint8_t side = flush.direction > 0 ? 0 : 1;
+  ev.raw = this->wheel_codes_[side];
+  ev.has_raw = true;
+  ev.steps = flush.steps;
+  ev.delta = flush.delta;
+  if (this->wheel_modifier_ != ButtonId::NONE) {
+    ev.action = this->profile_->button_chord(this->wheel_modifier_, flush.direction);
+    ev.gesture = this->wheel_gesture_;
+    this->emit_(ev);
+    return;
+  }
+  ev.action = this->wheel_actions_ != nullptr ? this->wheel_actions_[side] : nullptr;
+  this->emit_(ev);
+
+  if (this->wheel_delta_sink_)
+    this->wheel_delta_sink_(flush.delta);
+}
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "gesture.h"
+#include "gesture_dfa.h"
+#include "notify_queue.h"
+#include "profile.h"
+#include "remote_event.h"
+#include "wheel.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+// Plain wheel rotation (no chord), for a WheelNumber.
+using WheelDeltaSink = std::function<void(int16_t delta)>;
+
+// -----------------------------------------------------------------------------
+// Notify-to-event path of one remote: profile decoding, the gesture engine,
+// wheel coalescing and toggles. Transport independent; the component feeds it
+// queued notifications and receives RemoteEvents through the sink.
+// -----------------------------------------------------------------------------
+class EventPipeline {
+ public:
+  void set_profile(const RemoteProfile *profile) {
+    this->profile_ = profile;
+    this->gestures_.set_profile(profile);
+    this->decoder_.set_profile(profile);
+  }
+  void set_gestures(const GestureTable *table) { this->gestures_.set_gestures(table); }
+  void set_sink(GestureSink sink) {
+    this->gestures_.set_sink(sink);
+    this->sink_ = std::move(sink);
+  }
+  void set_wheel_delta_sink(WheelDeltaSink sink) { this->wheel_delta_sink_ = std::move(sink); }
+
+  const RemoteProfile *profile() const { return this->profile_; }
+  GestureEngine &gestures() { return this->gestures_; }
+  const GestureEngine &gestures() const { return this->gestures_; }
+  WheelCoalescer &wheel() { return this->wheel_; }
+  const WheelCoalescer &wheel() const { return this->wheel_; }
+
+  // One queued notification. Deadlines due before its arrival fire first.
+  void feed(const NotifyRecord &record);
+  // After a batch: deadlines due at `now_us`, wheel windows closing at `now_ms`.
+  void poll(uint32_t now_us, uint32_t now_ms);
+  // New connection or another remote: forget held buttons, pending gestures and ticks.
+  void reset();
+
+ protected:
+  void decode_(const NotifyRecord &record);
+  void emit_(const RemoteEvent &event) {
+    if (this->sink_)
+      this->sink_(event);
+  }
+  void emit_wheel_(const WheelFlush &flush);
+
+  const RemoteProfile *profile_{nullptr};
+  ReportDecoder decoder_;
+  GestureEngine gestures_;
+  WheelCoalescer wheel_;
+  GestureSink sink_;
+  WheelDeltaSink wheel_delta_sink_;
+  uint32_t toggle_state_{0};
+  const char *const *wheel_actions_{nullptr};
+  uint16_t wheel_codes_[2]{};
+  ButtonId wheel_modifier_{ButtonId::NONE};
+  uint16_t wheel_gesture_{0};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
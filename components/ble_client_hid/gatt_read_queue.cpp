@@ -0,0 +1,114 @@
+#include "gatt_read_queue.h"
+
+#include <cstring>
+#include <utility>
+
+namespace esphome {
+namespace ble_client_hid {
+
+bool GATTReadQueue::enqueue(uint16_t handle, uint16_t uuid, GATTReadCallback callback) {
+  if (handle == 0 || this->count_ >= GATT_READ_QUEUE_SIZE)
+    return false;
+  auto &req = this->requests_[(this->head_ + this->count_) % GATT_READ_QUEUE_SIZE];
+  req.handle = handle;
+  req.uuid = uuid;
+  req.callback = std::move(callback);
+  this->count_++;
+  return true;
+}
+
+bool GATTReadQueue::on_read_result(uint16_t handle, int status, const uint8_t *value, uint16_t value_len,
+                                   uint32_t now_ms) {
+  if (!this->in_flight_ || handle != this->current_.handle)
+    return false;
+  this->finish_(status, value, value_len, now_ms);
+  return true;
+}
+
+void GATTReadQueue::loop(uint32_t now_ms) {
+  if (this->in_flight_ && (int32_t) (now_ms - this->deadline_ms_) >= 0) {
+    this->finish_(GATT_READ_STATUS_TIMEOUT, nullptr, 0, now_ms);
+    return;
+  }
+  if (!this->in_flight_)
+    this->start_next_(now_ms);
+}
+
+void GATTReadQueue::clear() {
+  for (auto &req : this->requests_)
+    req.callback = nullptr;
+  this->current_.callback = nullptr;
+  this->head_ = 0;
+  this->count_ = 0;
+  this->in_flight_ = false;
+}
+
+void GATTReadQueue::start_next_(uint32_t now_ms) {
+  while (!this->in_flight_ && this->count_ > 0) {
+    this->current_ = std::move(this->requests_[this->head_]);
+    this->requests_[this->head_].callback = nullptr;
+    this->head_ = (this->head_ + 1) % GATT_READ_QUEUE_SIZE;
+    this->count_--;
+
+    if (this->issue_ && this->issue_(this->current_.handle)) {
+      this->in_flight_ = true;
+      this->deadline_ms_ = now_ms + GATT_READ_TIMEOUT_MS;
+      return;
+    }
+    // Refused by the stack: report it and move straight on to the next one.
+    GATTReadData *data = this->acquire_buffer_();
+    if (data == nullptr)
+      continue;
+    this->fill_(data, this->current_, GATT_READ_STATUS_ISSUE_FAILED, nullptr, 0);
+    if (this->current_.callback)
+      this->current_.callback(*data);
+    this->current_.callback = nullptr;
+    data->in_use_ = false;
+  }
+}
+
+void GATTReadQueue::finish_(int status, const uint8_t *value, uint16_t value_len, uint32_t now_ms) {
+  Request done = std::move(this->current_);
+  this->current_.callback = nullptr;
+  this->in_flight_ = false;
+
+  GATTReadData *data = this->acquire_buffer_();
+  if (data != nullptr)
+    this->fill_(data, done, status, value, value_len);
+
+  // Keep the link busy: the next read goes out before this result is processed.
+  this->start_next_(now_ms);
+
+  if (data == nullptr)
+    return;
+  if (done.callback)
+    done.callback(*data);
+  data->in_use_ = false;
+}
+
+void GATTReadQueue::fill_(GATTReadData *data, const Request &req, int status, const uint8_t *value,
+                          uint16_t value_len) {
+  data->handle_ = req.handle;
+  data->uuid_ = req.uuid;
+  data->status_ = status;
+  data->truncated_ = value_len > GATT_READ_BUFFER_SIZE;
+  data->value_len_ = data->truncated_ ? GATT_READ_BUFFER_SIZE : value_len;
+  if (value != nullptr && data->value_len_ > 0) {
+    memcpy(data->value_, value, data->value_len_);
+  } else {
+    data->value_len_ = 0;
+  }
+}
+
+GATTReadData *GATTReadQueue::acquire_buffer_() {
+  for (auto &buf : this->pool_) {
+    if (!buf.in_use_) {
+      buf.in_use_ = true;
+      return &buf;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace esphome {
+namespace ble_client_hid {
+
+// Largest attribute value the GATT spec allows (Core 5.x, Vol 3, Part F, 3.2.9).
+// Bluedroid performs the Read Blob continuation of long values itself and hands
+// us the reassembled value in a single READ_CHAR event.
+static constexpr uint16_t GATT_READ_BUFFER_SIZE = 512;
+// Two buffers: one can be handed to a callback while the next read is in flight.
+static constexpr uint8_t GATT_READ_POOL_SIZE = 2;
+static constexpr uint8_t GATT_READ_QUEUE_SIZE = 8;
+static constexpr uint32_t GATT_READ_TIMEOUT_MS = 3000;
+
+// Status values beyond esp_gatt_status_t (0 == ESP_GATT_OK).
+static constexpr int GATT_READ_STATUS_TIMEOUT = -1;
+static constexpr int GATT_READ_STATUS_ISSUE_FAILED = -2;
+
+class GATTReadData {
+ public:
+  bool ok() const { return this->status_ == 0; }
+
+ public:
+  uint8_t value_[GATT_READ_BUFFER_SIZE];
+  uint16_t value_len_{0};
+  uint16_t handle_{0};
+  uint16_t uuid_{0};
+  int status_{0};
+  bool truncated_{false};
+  bool in_use_{false};
+};
+
+using GATTReadCallback = std::function<void(const GATTReadData &data)>;
+
+// Serialises characteristic reads: one read in flight, each with a deadline.
+// Results land in a fixed pool of buffers and are delivered by callback; the
+// buffer is returned to the pool as soon as the callback returns.
+class GATTReadQueue {
+ public:
+  // Issues the actual read for `handle`; returns false if the stack refused it.
+  using IssueFunction = std::function<bool(uint16_t handle)>;
+
+  void set_issue_function(IssueFunction issue) { this->issue_ = std::move(issue); }
+
+  bool enqueue(uint16_t handle, uint16_t uuid, GATTReadCallback callback);
+  // Feed a READ_CHAR result. Returns false if it does not belong to the read in flight.
+  bool on_read_result(uint16_t handle, int status, const uint8_t *value, uint16_t value_len, uint32_t now_ms);
+  // Starts the next queued read and expires the one in flight past its deadline.
+  void loop(uint32_t now_ms);
+  // Drops everything queued (e.g. on disconnect) without invoking callbacks.
+  void clear();
+
+  bool idle() const { return !this->in_flight_ && this->count_ == 0; }
+  uint8_t pending() const { return this->count_ + (this->in_flight_ ? 1 : 0); }
+
+ protected:
+  struct Request {
+    uint16_t handle{0};
+    uint16_t uuid{0};
+    GATTReadCallback callback;
+  };
+
+  void start_next_(uint32_t now_ms);
+  void finish_(int status, const uint8_t *value, uint16_t value_len, uint32_t now_ms);
+  void fill_(GATTReadData *data, const Request &req, int status, const uint8_t *value, uint16_t value_len);
+  GATTReadData *acquire_buffer_();
+
+  IssueFunction issue_;
+  std::array<Request, GATT_READ_QUEUE_SIZE> requests_{};
+  uint8_t head_{0};
+  uint8_t count_{0};
+
+  Request current_{};
+  bool in_flight_{false};
+  uint32_t deadline_ms_{0};
+
+  std::array<GATTReadData, GATT_READ_POOL_SIZE> pool_{};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
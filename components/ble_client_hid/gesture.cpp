@@ -0,0 +1,277 @@
+#include "gesture.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+void AdaptiveGapWindow::configure(uint32_t min_ms, uint32_t max_ms, uint8_t percentile, uint32_t margin_ms) {
+  this->enabled_ = true;
+  this->min_ms_ = min_ms;
+  this->max_ms_ = max_ms < min_ms ? min_ms : max_ms;
+  this->percentile_ = percentile > 100 ? 100 : percentile;
+  this->margin_ms_ = margin_ms;
+  this->recompute_();
+}
+
+bool AdaptiveGapWindow::add_gap(uint32_t gap_ms, bool continued) {
+  if (!this->enabled_ || gap_ms > this->max_ms_)
+    return false;
+  // Spaced single clicks say nothing about how fast this user multi-presses.
+  if (!continued && gap_ms > this->window_ms_ + ADAPTIVE_GAP_NEAR_MISS_MS)
+    return false;
+  uint32_t bin = gap_ms / ADAPTIVE_GAP_BIN_MS;
+  if (bin >= ADAPTIVE_GAP_BINS)
+    bin = ADAPTIVE_GAP_BINS - 1;
+  this->bins_[bin]++;
+  this->total_++;
+  if (this->total_ >= ADAPTIVE_GAP_DECAY_TOTAL) {
+    this->total_ = 0;
+    for (auto &b : this->bins_) {
+      b /= 2;
+      this->total_ += b;
+    }
+  }
+  const uint32_t before = this->window_ms_;
+  this->recompute_();
+  return this->window_ms_ != before;
+}
+
+bool AdaptiveGapWindow::load(const AdaptiveGapBlob &blob) {
+  if (blob.magic != ADAPTIVE_GAP_MAGIC || blob.version != ADAPTIVE_GAP_VERSION)
+    return false;
+  this->total_ = 0;
+  for (uint8_t i = 0; i < ADAPTIVE_GAP_BINS; i++) {
+    this->bins_[i] = blob.bins[i];
+    this->total_ += blob.bins[i];
+  }
+  this->recompute_();
+  return true;
+}
+
+void AdaptiveGapWindow::clear() {
+  for (auto &b : this->bins_)
+    b = 0;
+  this->total_ = 0;
+  this->recompute_();
+}
+
+void AdaptiveGapWindow::store(AdaptiveGapBlob &blob) const {
+  blob = AdaptiveGapBlob{};
+  blob.window_ms = (uint16_t) this->window_ms_;
+  for (uint8_t i = 0; i < ADAPTIVE_GAP_BINS; i++)
+    blob.bins[i] = this->bins_[i];
+}
+
+void AdaptiveGapWindow::recompute_() {
+  uint32_t window = DEFAULT_MULTIPRESS_GAP_MS;
+  if (this->total_ >= ADAPTIVE_GAP_MIN_SAMPLES) {
+    // Upper edge of the bin holding the percentile.
+    const uint32_t target = ((uint32_t) this->total_ * this->percentile_ + 99) / 100;
+    uint32_t seen = 0;
+    uint8_t i = 0;
+    for (; i < ADAPTIVE_GAP_BINS - 1; i++) {
+      seen += this->bins_[i];
+      if (seen >= target)
+        break;
+    }
+    window = (i + 1) * ADAPTIVE_GAP_BIN_MS + this->margin_ms_;
+  }
+  if (window < this->min_ms_)
+    window = this->min_ms_;
+  if (window > this->max_ms_)
+    window = this->max_ms_;
+  this->window_ms_ = window;
+}
+
+void GestureEngine::press(ButtonId button, uint16_t raw, uint32_t t_us) {
+  if (static_cast<uint8_t>(button) >= this->button_count())
+    return;
+  auto &inst = this->state_;
+  auto &st = inst.st[(uint8_t) button];
+  const auto &cfg = this->config(button);
+  if (!st.is_down)
+    inst.held_count++;
+  st.is_down = true;
+  st.long_fired = false;
+  st.chorded = false;
+  st.repeat_index = 0;
+
+  // A sequence this press cannot continue is complete now, not at its timeout.
+  inst.timeout_armed = false;
+  const uint8_t index = static_cast<uint8_t>(button);
+  const bool continues = inst.dfa_state != GESTURE_ROOT &&
+                         (this->table_->step(inst.dfa_state, gesture_token(index, false)) != GESTURE_NO_STATE ||
+                          this->table_->step(inst.dfa_state, gesture_token(index, true)) != GESTURE_NO_STATE);
+  // Release-to-press gap of a click follow-up of the same button.
+  if (st.click_released && cfg.multi_press &&
+      this->adaptive_.add_gap((t_us - st.released_us) / 1000, continues && inst.last_button == index))
+    this->window_changed_ = true;
+  st.click_released = false;
+  if (inst.dfa_state != GESTURE_ROOT && !continues)
+    this->flush_();
+  if (inst.dfa_state == GESTURE_ROOT)
+    inst.sequence_id = inst.next_gesture_id();
+  st.gesture_id = inst.sequence_id;
+
+  // A hold that starts repeating first is a repeat run, never a long press.
+  if (cfg.repeat && cfg.repeat_delay_ms <= cfg.long_press_ms) {
+    st.cancel(GestureTimer::LONG);
+  } else {
+    st.arm(GestureTimer::LONG, t_us + cfg.long_press_ms * 1000);
+  }
+  if (cfg.repeat) {
+    st.repeat_interval_us = cfg.repeat_interval_ms * 1000;
+    st.arm(GestureTimer::REPEAT, t_us + cfg.repeat_delay_ms * 1000);
+  } else {
+    st.cancel(GestureTimer::REPEAT);
+  }
+
+  this->emit_(RemoteEvent{this->action_(button, ButtonGesture::PRESSED), raw, true, -1});
+}
+
+void GestureEngine::release(ButtonId rb, uint16_t raw, uint32_t t_us) {
+  if (static_cast<uint8_t>(rb) >= this->button_count())
+    return;
+  auto &st = this->state_.st[(uint8_t) rb];
+  if (!st.is_down)
+    return;
+  st.is_down = false;
+  this->state_.held_count--;
+  st.cancel(GestureTimer::LONG);
+  st.cancel(GestureTimer::REPEAT);
+
+  this->emit_(RemoteEvent{this->action_(rb, ButtonGesture::RELEASED), raw, true, -1});
+
+  // The long token was stepped when long_press passed; a hold that repeated or
+  // served as a modifier already ended the sequence.
+  st.click_released = false;
+  if (st.long_fired || st.repeat_index > 0 || st.chorded) {
+    st.long_fired = false;
+    st.repeat_index = 0;
+    st.chorded = false;
+  } else {
+    this->step_(gesture_token((uint8_t) rb, false));
+    st.click_released = true;
+    st.released_us = t_us;
+  }
+  this->arm_timeout_(t_us);
+}
+
+void GestureEngine::step_(uint16_t token) {
+  auto &inst = this->state_;
+  uint16_t next = this->table_->step(inst.dfa_state, token);
+  if (next == GESTURE_NO_STATE && inst.dfa_state != GESTURE_ROOT) {
+    // Dead end: what was matched so far stands, the token starts a new sequence.
+    this->flush_();
+    inst.sequence_id = inst.next_gesture_id();
+    next = this->table_->step(GESTURE_ROOT, token);
+  }
+  if (next == GESTURE_NO_STATE)
+    return;
+  inst.dfa_state = next;
+  inst.last_button = gesture_token_button(token);
+
+  const GestureState &state = this->table_->states[next];
+  if (state.flags & GESTURE_FLAG_LEAF) {
+    this->flush_();
+  } else if (state.flags & GESTURE_FLAG_PROVISIONAL) {
+    RemoteEvent ev{state.action, 0, false, state.clicks};
+    ev.gesture = inst.sequence_id;
+    ev.provisional = true;
+    this->emit_(ev);
+    inst.provisional_state = next;
+  }
+}
+
+void GestureEngine::flush_() {
+  auto &inst = this->state_;
+  const GestureState &state = this->table_->states[inst.dfa_state];
+  if (inst.dfa_state != GESTURE_ROOT && state.action != nullptr && inst.dfa_state != inst.provisional_state) {
+    RemoteEvent ev{state.action, 0, false, state.clicks};
+    ev.gesture = inst.sequence_id;
+    this->emit_(ev);
+  }
+  inst.dfa_state = GESTURE_ROOT;
+  inst.provisional_state = GESTURE_NO_STATE;
+  inst.timeout_armed = false;
+}
+
+void GestureEngine::arm_timeout_(uint32_t t_us) {
+  auto &inst = this->state_;
+  if (inst.held_count > 0 || inst.dfa_state == GESTURE_ROOT)
+    return;
+  uint32_t timeout_ms = this->table_->states[inst.dfa_state].timeout_ms;
+  if (timeout_ms == 0)
+    timeout_ms = this->multi_press_gap_ms_(this->config_[inst.last_button]);
+  inst.timeout_us = t_us + timeout_ms * 1000;
+  inst.timeout_armed = true;
+}
+
+ButtonId GestureEngine::held_button() const {
+  if (this->state_.held_count == 0)
+    return ButtonId::NONE;
+  const uint8_t count = this->button_count();
+  for (uint8_t i = 0; i < count; i++) {
+    if (this->state_.st[i].is_down)
+      return (ButtonId) i;
+  }
+  return ButtonId::NONE;
+}
+
+uint16_t GestureEngine::use_as_modifier(ButtonId button) {
+  auto &st = this->state_.st[(uint8_t) button];
+  if (!st.chorded) {
+    st.chorded = true;
+    st.click_released = false;
+    st.cancel(GestureTimer::LONG);
+    st.cancel(GestureTimer::REPEAT);
+    this->flush_();
+  }
+  return st.gesture_id;
+}
+
+void GestureEngine::advance(uint32_t now_us) {
+  auto &inst = this->state_;
+  if (inst.timeout_armed && (int32_t) (now_us - inst.timeout_us) >= 0)
+    this->flush_();
+
+  const uint8_t count = this->button_count();
+  for (uint8_t i = 0; i < count; i++) {
+    auto &st = inst.st[i];
+    if (st.armed == 0)
+      continue;
+    const ButtonId btn = (ButtonId) i;
+    const auto &cfg = this->config_[i];
+
+    if (st.take_due(GestureTimer::LONG, now_us) && st.is_down && !st.long_fired) {
+      st.long_fired = true;
+      this->step_(gesture_token(i, true));
+    }
+
+    if (st.take_due(GestureTimer::REPEAT, now_us) && st.is_down) {
+      if (st.repeat_index == 0) {
+        st.cancel(GestureTimer::LONG);
+        this->flush_();
+      }
+      if (st.repeat_index < UINT16_MAX)
+        st.repeat_index++;
+
+      RemoteEvent ev{this->action_(btn, ButtonGesture::REPEAT), 0, false, -1};
+      ev.gesture = st.gesture_id;
+      ev.repeat = st.repeat_index;
+      this->emit_(ev);
+
+      // Next deadline from the previous one, so a late call does not stretch the ramp;
+      // after a long stall, resume from now instead of sending a burst.
+      uint32_t next_us = st.deadline_us[(uint8_t) GestureTimer::REPEAT] + st.repeat_interval_us;
+      if ((int32_t) (now_us - next_us) >= 0)
+        next_us = now_us + st.repeat_interval_us;
+      st.arm(GestureTimer::REPEAT, next_us);
+      const uint32_t ramped_us = (uint32_t) (((uint64_t) st.repeat_interval_us * cfg.repeat_ramp_q8) >> 8);
+      const uint32_t min_us = cfg.repeat_min_interval_ms * 1000;
+      st.repeat_interval_us = ramped_us < min_us ? min_us : ramped_us;
+    }
+  }
+}
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "gesture_dfa.h"
+#include "profile.h"
+#include "remote_event.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+// Multi-press timing defaults (device-side interpretation)
+static constexpr uint32_t DEFAULT_MULTIPRESS_GAP_MS = 400;
+static constexpr uint32_t DEFAULT_LONG_PRESS_MS = 1500;
+
+// Per-button gesture options, from the `buttons:` YAML block. multi_press and
+// speculative_single shape the compiled GestureTable; they are kept here for
+// dump_config() and the adaptive window.
+struct ButtonConfig {
+  // false: no double/triple patterns, *_single fires at release.
+  bool multi_press{true};
+  // Wait for the next press, for states without a timeout of their own.
+  uint32_t multi_press_gap_ms{DEFAULT_MULTIPRESS_GAP_MS};
+  uint32_t long_press_ms{DEFAULT_LONG_PRESS_MS};
+  // Send a provisional *_single at the first release; a longer pattern with
+  // the same gesture number supersedes it.
+  bool speculative_single{false};
+
+  // Hold-to-repeat: *_repeat every interval after `repeat_delay_ms`, with the
+  // interval shrinking by `repeat_ramp_q8` / 256 per repeat down to the minimum.
+  bool repeat{false};
+  uint32_t repeat_delay_ms{500};
+  uint32_t repeat_interval_ms{250};
+  uint32_t repeat_min_interval_ms{50};
+  uint16_t repeat_ramp_q8{205};  // ~0.8
+};
+
+// -----------------------------------------------------------------------------
+// Adaptive multi-press window: learns the release-to-next-press gaps of this
+// remote's user and sizes the window to a percentile of them plus a margin.
+// -----------------------------------------------------------------------------
+static constexpr uint8_t ADAPTIVE_GAP_BINS = 40;
+static constexpr uint32_t ADAPTIVE_GAP_BIN_MS = 25;  // histogram covers 0..1000 ms
+static constexpr uint16_t ADAPTIVE_GAP_MIN_SAMPLES = 8;
+// Counts are halved when the total reaches this, so old habits fade out.
+static constexpr uint16_t ADAPTIVE_GAP_DECAY_TOTAL = 256;
+// A gap that ended no multi-press is still recorded this close past the
+// window, so a window that is too short can grow.
+static constexpr uint32_t ADAPTIVE_GAP_NEAR_MISS_MS = 150;
+
+static constexpr uint32_t ADAPTIVE_GAP_MAGIC = 0x41475031;  // "AGP1"
+static constexpr uint8_t ADAPTIVE_GAP_VERSION = 1;
+
+// Persisted form (ESPPreference), see BLEClientHID::setup().
+struct AdaptiveGapBlob {
+  uint32_t magic{ADAPTIVE_GAP_MAGIC};
+  uint8_t version{ADAPTIVE_GAP_VERSION};
+  uint8_t reserved{0};
+  uint16_t window_ms{0};
+  uint16_t bins[ADAPTIVE_GAP_BINS]{};
+};
+
+class AdaptiveGapWindow {
+ public:
+  void configure(uint32_t min_ms, uint32_t max_ms, uint8_t percentile, uint32_t margin_ms);
+  bool is_enabled() const { return this->enabled_; }
+  uint32_t window_ms() const { return this->window_ms_; }
+  uint16_t samples() const { return this->total_; }
+
+  // Records one gap; returns true if the window changed. `continued`: the
+  // press after the gap continued a multi-press. Other gaps only count within
+  // ADAPTIVE_GAP_NEAR_MISS_MS past the window.
+  bool add_gap(uint32_t gap_ms, bool continued);
+  bool load(const AdaptiveGapBlob &blob);
+  void store(AdaptiveGapBlob &blob) const;
+  // Forgets all gaps (another remote took over the connection).
+  void clear();
+
+ protected:
+  void recompute_();
+
+  bool enabled_{false};
+  uint32_t min_ms_{0};
+  uint32_t max_ms_{0};
+  uint8_t percentile_{95};
+  uint32_t margin_ms_{0};
+  uint32_t window_ms_{DEFAULT_MULTIPRESS_GAP_MS};
+  uint16_t bins_[ADAPTIVE_GAP_BINS]{};
+  uint16_t total_{0};
+};
+
+// Hold deadlines, one slot of each kind per button.
+enum class GestureTimer : uint8_t { LONG = 0, REPEAT, COUNT };
+
+static constexpr uint8_t GESTURE_TIMER_COUNT = static_cast<uint8_t>(GestureTimer::COUNT);
+
+// -----------------------------------------------------------------------------
+// Button state (per instance) - only for "real buttons", not wheel events.
+// -----------------------------------------------------------------------------
+struct ButtonState {
+  bool is_down{false};
+  bool long_fired{false};
+  bool chorded{false};  // used as a modifier during this hold
+  uint16_t gesture_id{0};
+
+  // End of the last click, for the adaptive window
+  bool click_released{false};
+  uint32_t released_us{0};
+
+  // Hold-to-repeat
+  uint16_t repeat_index{0};
+  uint32_t repeat_interval_us{0};
+
+  // Deadlines on the notification clock (micros, wrap-safe); serviced from loop().
+  uint32_t deadline_us[GESTURE_TIMER_COUNT]{};
+  uint8_t armed{0};  // bit per GestureTimer
+
+  void arm(GestureTimer t, uint32_t at_us) {
+    this->deadline_us[static_cast<uint8_t>(t)] = at_us;
+    this->armed |= timer_bit(t);
+  }
+  void cancel(GestureTimer t) { this->armed &= ~timer_bit(t); }
+  bool is_armed(GestureTimer t) const { return (this->armed & timer_bit(t)) != 0; }
+  // True once, when an armed deadline has passed; the slot is disarmed.
+  bool take_due(GestureTimer t, uint32_t now_us) {
+    if (!this->is_armed(t) || (int32_t) (now_us - this->deadline_us[static_cast<uint8_t>(t)]) < 0)
+      return false;
+    this->cancel(t);
+    return true;
+  }
+
+  static uint8_t timer_bit(GestureTimer t) { return (uint8_t) (1u << static_cast<uint8_t>(t)); }
+};
+
+struct InstanceButtons {
+  std::array<ButtonState, MAX_BUTTONS> st{};
+  uint8_t held_count{0};
+  uint16_t last_gesture_id{0};
+
+  // Position in the gesture automaton, shared by all buttons of the remote.
+  uint16_t dfa_state{GESTURE_ROOT};
+  uint16_t provisional_state{GESTURE_NO_STATE};  // already emitted as provisional
+  uint16_t sequence_id{0};
+  uint8_t last_button{0};  // button of the last token, for the default timeout
+  bool timeout_armed{false};
+  uint32_t timeout_us{0};
+
+  uint16_t next_gesture_id() {
+    if (++this->last_gesture_id == 0)
+      this->last_gesture_id = 1;
+    return this->last_gesture_id;
+  }
+};
+
+using GestureSink = std::function<void(const RemoteEvent &event)>;
+
+// Turns button presses and releases of one remote into gesture events.
+//
+// Every finished hold is a token (short, or long once long_press passes) that
+// steps the compiled GestureTable: one hash probe per token, whatever the
+// number of patterns. A state with a pattern emits when nothing can follow it,
+// when its timeout passes without a press, or when the next token leads
+// nowhere from it.
+//
+// Time only enters through the timestamps passed in, never from a clock:
+// advance(t) fires every deadline at or before t. Calling advance() with each
+// record's arrival stamp before feeding it classifies on arrival times, so a
+// main loop that runs late still yields the gesture the user made.
+class GestureEngine {
+ public:
+  void set_sink(GestureSink sink) { this->sink_ = std::move(sink); }
+  // Names the buttons' actions; must be set before the first press.
+  void set_profile(const RemoteProfile *profile) { this->profile_ = profile; }
+  // Patterns compiled for this profile by gestures.py; must be set before the first press.
+  void set_gestures(const GestureTable *table) { this->table_ = table; }
+  uint8_t button_count() const {
+    if (this->profile_ == nullptr || this->table_ == nullptr)
+      return 0;
+    return this->profile_->button_count < MAX_BUTTONS ? this->profile_->button_count : MAX_BUTTONS;
+  }
+  ButtonConfig &config(ButtonId button) { return this->config_[static_cast<uint8_t>(button)]; }
+  const ButtonConfig &config(ButtonId button) const { return this->config_[static_cast<uint8_t>(button)]; }
+
+  // Press and release edges of one button; buttons are independent of each other.
+  void press(ButtonId button, uint16_t raw, uint32_t t_us);
+  void release(ButtonId button, uint16_t raw, uint32_t t_us);
+  // Fires the deadlines that are due at `now_us`.
+  void advance(uint32_t now_us);
+  void reset() { this->state_ = InstanceButtons{}; }
+
+  // First button held down, or NONE. Free when nothing is held.
+  ButtonId held_button() const;
+  // Marks `button` as a modifier for this hold: no *_long, *_repeat or pattern
+  // token will come from it. Returns the hold's gesture number.
+  uint16_t use_as_modifier(ButtonId button);
+
+  AdaptiveGapWindow &adaptive() { return this->adaptive_; }
+  const AdaptiveGapWindow &adaptive() const { return this->adaptive_; }
+  // True once after the adaptive window moved.
+  bool take_window_changed() {
+    const bool changed = this->window_changed_;
+    this->window_changed_ = false;
+    return changed;
+  }
+
+ protected:
+  uint32_t multi_press_gap_ms_(const ButtonConfig &cfg) const {
+    return this->adaptive_.is_enabled() ? this->adaptive_.window_ms() : cfg.multi_press_gap_ms;
+  }
+
+  void emit_(const RemoteEvent &event) {
+    if (this->sink_)
+      this->sink_(event);
+  }
+
+  const char *action_(ButtonId button, ButtonGesture gesture) const {
+    return this->profile_->button_action(button, gesture);
+  }
+
+  void step_(uint16_t token);
+  // Emits the pending pattern, if any, and returns to the root.
+  void flush_();
+  void arm_timeout_(uint32_t t_us);
+
+  const RemoteProfile *profile_{nullptr};
+  const GestureTable *table_{nullptr};
+  std::array<ButtonConfig, MAX_BUTTONS> config_{};
+  InstanceButtons state_{};
+  AdaptiveGapWindow adaptive_;
+  bool window_changed_{false};
+  GestureSink sink_;
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
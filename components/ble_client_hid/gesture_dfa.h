@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace ble_client_hid {
+
+// -----------------------------------------------------------------------------
+// Gesture automaton, generated by gestures.py into const tables (flash).
+//
+// Tokens are finished button holds: button index * 2, +1 for a long hold.
+// State 0 is the root, where no sequence is in progress.
+// -----------------------------------------------------------------------------
+static constexpr uint16_t GESTURE_ROOT = 0;
+static constexpr uint16_t GESTURE_NO_STATE = 0xFFFF;
+static constexpr uint32_t GESTURE_NO_EDGE = 0xFFFFFFFF;
+
+static constexpr uint8_t GESTURE_FLAG_LEAF = 0x01;         // emit on entry, nothing can follow
+static constexpr uint8_t GESTURE_FLAG_PROVISIONAL = 0x02;  // emit on entry as provisional, may be superseded
+
+inline uint16_t gesture_token(uint8_t button, bool is_long) { return (uint16_t) ((button << 1) | (is_long ? 1 : 0)); }
+inline uint8_t gesture_token_button(uint16_t token) { return (uint8_t) (token >> 1); }
+
+struct GestureState {
+  const char *action;   // pattern that ends here, nullptr if none
+  uint16_t timeout_ms;  // wait for the next press; 0: multi-press window of the last button
+  int8_t clicks;        // `clicks` of the emitted event
+  uint8_t flags;
+};
+
+struct GestureEdge {
+  uint32_t key;  // state << 16 | token, GESTURE_NO_EDGE if empty
+  uint16_t next;
+};
+
+struct GestureTable {
+  const GestureState *states;
+  uint16_t state_count;
+  const GestureEdge *edges;
+  // slot = (key * hash_mul) >> hash_shift, collision free for this table's keys
+  uint32_t hash_mul;
+  uint8_t hash_shift;
+
+  uint16_t step(uint16_t state, uint16_t token) const {
+    const uint32_t key = ((uint32_t) state << 16) | token;
+    const GestureEdge &edge = this->edges[(uint32_t) (key * this->hash_mul) >> this->hash_shift];
+    return edge.key == key ? edge.next : GESTURE_NO_STATE;
+  }
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
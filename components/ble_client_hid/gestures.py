@@ -0,0 +1,181 @@
+"""Gesture patterns -> DFA tables for GestureEngine (gesture_dfa.h).
+
+A pattern is a sequence of tokens. A token is one finished button hold:
+
+    "up"       short: released before long_press
+    "up:long"  long:  held for long_press
+
+Each remote gets the built-in patterns for its profile's buttons plus the
+custom ones from YAML. Per button they are `*_single` [b], `*_double` [b, b],
+`*_triple` [b, b, b] and `*_long` [b:long]. With multi_press: false only
+single and long are built in. All patterns are merged into one trie, which
+is already deterministic, and the trie becomes the automaton:
+
+- A state that ends a pattern and has no way on emits at once.
+- Any other state waits. If the next press does not come within its timeout,
+  the state's pattern, if any, is emitted.
+- A token with no transition ends the sequence and starts a new one at the
+  root.
+
+Transitions live in a perfect hash table keyed by (state, token), so one
+step costs the same for any number of patterns.
+
+This module has no ESPHome imports. Run it directly to regenerate the
+built-in Essence header:
+
+    python3 components/ble_client_hid/gestures.py
+"""
+
+import os
+import re
+
+try:
+    from .profiles import ESSENCE, compile_profile, find_hash
+except ImportError:  # run as a script
+    from profiles import ESSENCE, compile_profile, find_hash
+
+LONG_SUFFIX = ":long"
+
+FLAG_LEAF = 0x01
+FLAG_PROVISIONAL = 0x02
+
+# State timeout 0: the multi-press window of the last token's button.
+TIMEOUT_GAP = 0
+
+MAX_STATES = 0xFFFE
+_ACTION_RE = re.compile(r"^[a-z0-9_+]+$")
+
+
+class GestureError(Exception):
+    pass
+
+
+def parse_token(token, buttons):
+    """'up' / 'up:long' -> token number (button index * 2 + long)."""
+    is_long = token.endswith(LONG_SUFFIX)
+    name = token[: -len(LONG_SUFFIX)] if is_long else token
+    if name not in buttons:
+        raise GestureError(f"unknown button '{name}' in gesture")
+    return buttons.index(name) * 2 + (1 if is_long else 0)
+
+
+def builtin_patterns(buttons, multi_press):
+    """Built-in patterns; `multi_press` maps button name -> bool (default True)."""
+    patterns = []
+    for name in buttons:
+        patterns.append({"action": f"{name}_single", "sequence": [name], "clicks": 1})
+        if multi_press.get(name, True):
+            patterns.append({"action": f"{name}_double", "sequence": [name, name], "clicks": 2})
+            patterns.append({"action": f"{name}_triple", "sequence": [name, name, name], "clicks": 3})
+        patterns.append({"action": f"{name}_long", "sequence": [name + LONG_SUFFIX], "clicks": -1})
+    return patterns
+
+
+def compile_gestures(profile, multi_press=None, speculative=None, patterns=None):
+    """Builds the automaton for a compiled profile plus custom patterns.
+
+    Custom patterns are dicts with `action`, `sequence` and optional
+    `within_ms` (timeout of every state on the way). A custom pattern with
+    the same sequence as a built-in one replaces it.
+    """
+    buttons = profile["buttons"]
+    multi_press = multi_press or {}
+    speculative = speculative or {}
+
+    # state 0 is the root
+    states = [{"action": None, "clicks": -1, "timeout": TIMEOUT_GAP, "next": {}}]
+
+    def add(pattern):
+        if not _ACTION_RE.match(pattern["action"]):
+            raise GestureError(f"action '{pattern['action']}': lower case letters, digits, _ and + only")
+        if not pattern["sequence"]:
+            raise GestureError(f"action '{pattern['action']}': empty sequence")
+        state = 0
+        for token in pattern["sequence"]:
+            t = parse_token(token, buttons)
+            nxt = states[state]["next"].get(t)
+            if nxt is None:
+                nxt = len(states)
+                states.append({"action": None, "clicks": -1, "timeout": TIMEOUT_GAP, "next": {}})
+                states[state]["next"][t] = nxt
+            state = nxt
+            within = pattern.get("within_ms")
+            if within:
+                # Shared prefixes wait for the most patient pattern.
+                current = states[state]["timeout"]
+                states[state]["timeout"] = max(current, within) if current else within
+        states[state]["action"] = pattern["action"]
+        states[state]["clicks"] = pattern.get("clicks", -1)
+
+    for pattern in builtin_patterns(buttons, multi_press):
+        add(pattern)
+    for pattern in patterns or []:
+        add(pattern)
+    if len(states) > MAX_STATES:
+        raise GestureError("too many gesture states")
+
+    for state in states[1:]:
+        state["flags"] = FLAG_LEAF if not state["next"] else 0
+    states[0]["flags"] = 0
+    for name in buttons:
+        if speculative.get(name):
+            single = states[states[0]["next"][parse_token(name, buttons)]]
+            if not single["flags"] & FLAG_LEAF:
+                single["flags"] |= FLAG_PROVISIONAL
+
+    edges = [(s << 16 | t, n) for s, state in enumerate(states) for t, n in state["next"].items()]
+    mul, shift = find_hash([k for k, _ in edges])
+    table = [None] * (1 << (32 - shift))
+    for key, nxt in edges:
+        table[((key * mul) & 0xFFFFFFFF) >> shift] = (key, nxt)
+    return {"states": states, "edges": table, "hash_mul": mul, "hash_shift": shift}
+
+
+def gestures_symbol(name):
+    return f"GESTURES_{name.upper()}"
+
+
+def render_gestures(compiled, name):
+    """C++ definition of the automaton (inside namespace ble_client_hid)."""
+    sym = gestures_symbol(name)
+    lines = [f"static const GestureState {sym}_STATES[] = {{"]
+    for state in compiled["states"]:
+        action = f'"{state["action"]}"' if state["action"] else "nullptr"
+        lines.append(f"    {{{action}, {state['timeout']}, {state['clicks']}, 0x{state['flags']:02x}}},")
+    lines.append("};")
+    lines.append(f"static const GestureEdge {sym}_EDGES[] = {{")
+    for edge in compiled["edges"]:
+        if edge is None:
+            lines.append("    {GESTURE_NO_EDGE, 0},")
+        else:
+            lines.append(f"    {{0x{edge[0]:08x}u, {edge[1]}}},")
+    lines.append("};")
+    lines.append(
+        f"static const GestureTable {sym} = {{{sym}_STATES, {len(compiled['states'])}, {sym}_EDGES, "
+        f"0x{compiled['hash_mul']:08x}u, {compiled['hash_shift']}}};"
+    )
+    return "\n".join(lines)
+
+
+def render_header(compiled, name):
+    return (
+        "#pragma once\n"
+        "\n"
+        "// Generated by gestures.py - do not edit.\n"
+        "\n"
+        '#include "gesture_dfa.h"\n'
+        "\n"
+        "namespace esphome {\n"
+        "namespace ble_client_hid {\n"
+        "\n"
+        f"{render_gestures(compiled, name)}\n"
+        "\n"
+        "}  // namespace ble_client_hid\n"
+        "}  // namespace esphome\n"
+    )
+
+
+if __name__ == "__main__":
+    here = os.path.dirname(os.path.abspath(__file__))
+    with open(os.path.join(here, "gestures_essence.h"), "w") as header_file:
+        header_file.write(render_header(compile_gestures(compile_profile(ESSENCE)), "essence"))
@@ -0,0 +1,50 @@
+#pragma once
+
+// Generated by gestures.py - do not edit.
+
+#include "gesture_dfa.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+static const GestureState GESTURES_ESSENCE_STATES[] = {
+    {nullptr, 0, -1, 0x00},
+    {"up_single", 0, 1, 0x00},
+    {"up_double", 0, 2, 0x00},
+    {"up_triple", 0, 3, 0x01},
+    {"up_long", 0, -1, 0x01},
+    {"down_single", 0, 1, 0x00},
+    {"down_double", 0, 2, 0x00},
+    {"down_triple", 0, 3, 0x01},
+    {"down_long", 0, -1, 0x01},
+    {"left_single", 0, 1, 0x00},
+    {"left_double", 0, 2, 0x00},
+    {"left_triple", 0, 3, 0x01},
+    {"left_long", 0, -1, 0x01},
+    {"right_single", 0, 1, 0x00},
+    {"right_double", 0, 2, 0x00},
+    {"right_triple", 0, 3, 0x01},
+    {"right_long", 0, -1, 0x01},
+};
+static const GestureEdge GESTURES_ESSENCE_EDGES[] = {
+    {0x00000000u, 1},
+    {0x00050002u, 6},
+    {0x000a0004u, 11},
+    {0x00000007u, 16},
+    {0x00000004u, 9},
+    {0x00000001u, 4},
+    {0x00020000u, 3},
+    {0x00090004u, 10},
+    {0x000e0006u, 15},
+    {0x00000005u, 12},
+    {0x00000002u, 5},
+    {0x00010000u, 2},
+    {0x00060002u, 7},
+    {0x000d0006u, 14},
+    {0x00000006u, 13},
+    {0x00000003u, 8},
+};
+static const GestureTable GESTURES_ESSENCE = {GESTURES_ESSENCE_STATES, 17, GESTURES_ESSENCE_EDGES, 0x500cb111u, 28};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
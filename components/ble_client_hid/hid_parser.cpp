@@ -1,6 +1,7 @@
+#include <cstdarg>
+#include <cstdio>
 #include <stack>
 #include <map>
-#include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 
 #include "hid_report_data.h"
@@ -125,7 +126,7 @@ namespace esphome
 
     const HIDUsage HIDUsageList::get_usage(uint16_t index) const
     {
-      ESP_LOGD(TAG, "get usage for index %d with list size %d", index, this->usages.size());
+      ESP_LOGD(TAG, "get usage for index %d with list size %u", index, (unsigned) this->usages.size());
       if (index > this->usages.size())
       {
         ESP_LOGW(TAG, "Usage index out of range");
@@ -318,7 +319,7 @@ namespace esphome
         }
       }
       HIDReportMap *report_map = new HIDReportMap(input_reports);
-      ESP_LOGD(TAG, "Parsed report map with %d input reports", input_reports.size());
+      ESP_LOGD(TAG, "Parsed report map with %u input reports", (unsigned) input_reports.size());
       return report_map;
     }
 
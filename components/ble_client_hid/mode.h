@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace esphome {
+namespace ble_client_hid {
+
+static constexpr uint8_t MAX_MODES = 8;
+
+// Persisted form (ESPPreference), see BLEClientHID::setup().
+struct ModeBlob {
+  uint32_t names_hash{0};  // modes renamed or reordered: start at the first one
+  uint8_t index{0};
+};
+
+// -----------------------------------------------------------------------------
+// Modes (layers): one remote drives several targets. The switch actions move
+// between the configured modes; every other event is tagged with the current
+// one, so automations branch on the event alone.
+// -----------------------------------------------------------------------------
+class ModeLayer {
+ public:
+  // `name` must outlive the layer (string literal from codegen).
+  bool add_mode(const char *name) {
+    if (this->count_ >= MAX_MODES)
+      return false;
+    this->names_[this->count_++] = name;
+    return true;
+  }
+  // Actions that step to the next / previous mode; either may be nullptr.
+  void set_switch_actions(const char *next, const char *previous) {
+    this->next_ = next;
+    this->previous_ = previous;
+  }
+
+  bool is_enabled() const { return this->count_ > 0; }
+  uint8_t count() const { return this->count_; }
+  uint8_t current() const { return this->current_; }
+  const char *current_name() const { return this->count_ > 0 ? this->names_[this->current_] : nullptr; }
+  const char *name(uint8_t index) const { return index < this->count_ ? this->names_[index] : nullptr; }
+
+  bool select(uint8_t index) {
+    if (index >= this->count_)
+      return false;
+    this->current_ = index;
+    return true;
+  }
+
+  // Steps the mode if `action` is a switch action; true if it was one.
+  bool handle_action(const char *action) {
+    if (this->count_ == 0 || action == nullptr)
+      return false;
+    if (this->next_ != nullptr && std::strcmp(action, this->next_) == 0) {
+      this->current_ = (uint8_t) ((this->current_ + 1) % this->count_);
+      return true;
+    }
+    if (this->previous_ != nullptr && std::strcmp(action, this->previous_) == 0) {
+      this->current_ = (uint8_t) ((this->current_ + this->count_ - 1) % this->count_);
+      return true;
+    }
+    return false;
+  }
+
+  // FNV-1a over the mode names, to tell a stored index from a stale one.
+  uint32_t names_hash() const {
+    uint32_t hash = 2166136261u;
+    for (uint8_t i = 0; i < this->count_; i++) {
+      for (const char *c = this->names_[i]; *c != '\0'; c++)
+        hash = (hash ^ (uint8_t) *c) * 16777619u;
+      hash = (hash ^ 0xFFu) * 16777619u;  // separator
+    }
+    return hash;
+  }
+
+  bool load(const ModeBlob &blob) {
+    if (blob.names_hash != this->names_hash())
+      return false;
+    return this->select(blob.index);
+  }
+  void store(ModeBlob &blob) const {
+    blob.names_hash = this->names_hash();
+    blob.index = this->current_;
+  }
+
+ protected:
+  const char *names_[MAX_MODES]{};
+  uint8_t count_{0};
+  uint8_t current_{0};
+  const char *next_{nullptr};
+  const char *previous_{nullptr};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace ble_client_hid {
+
+// Cached + discovered (+ optional fallback) pairs; a remote exposes a handful.
+static constexpr uint8_t MAX_NOTIFY_PAIRS = 8;
+
+static constexpr uint16_t CCC_NOTIFY = 0x0001;
+static constexpr uint16_t CCC_INDICATE = 0x0002;
+
+struct NotifyPair {
+  uint16_t input_handle{0};  // characteristic value handle
+  uint16_t ccc_handle{0};    // 0x2902 descriptor handle
+
+  bool operator==(const NotifyPair &o) const { return input_handle == o.input_handle && ccc_handle == o.ccc_handle; }
+};
+
+// One CCC descriptor: the value we want in it and how the last write went.
+struct CccEntry {
+  uint16_t ccc_handle{0};
+  uint16_t desired{CCC_NOTIFY};
+  bool enabled{false};
+  uint32_t last_attempt_ms{0};
+};
+
+// -----------------------------------------------------------------------------
+// Persisted handle cache (Preferences / NVS) per remote MAC
+// -----------------------------------------------------------------------------
+static constexpr uint32_t HANDLE_CACHE_MAGIC = 0xB0E05A11;
+static constexpr uint8_t HANDLE_CACHE_VERSION = 1;
+static constexpr uint8_t HANDLE_CACHE_MAX_PAIRS = 6;
+
+struct HandleCacheBlob {
+  uint32_t magic{HANDLE_CACHE_MAGIC};
+  uint8_t version{HANDLE_CACHE_VERSION};
+  uint8_t count{0};
+  uint16_t reserved{0};
+  NotifyPair pairs[HANDLE_CACHE_MAX_PAIRS]{};
+};
+
+// -----------------------------------------------------------------------------
+// Notify pairs and CCC state of one remote. Fixed capacity and owned by the
+// component, so the notify path is a short linear scan with no allocation.
+// -----------------------------------------------------------------------------
+struct RemoteBleState {
+  NotifyPair pairs[MAX_NOTIFY_PAIRS]{};
+  uint8_t pair_count{0};
+  CccEntry ccc[MAX_NOTIFY_PAIRS]{};
+  uint8_t ccc_count{0};
+
+  bool loaded_pairs{false};
+  uint32_t last_notify_ms{0};
+
+  // HID service range (0x1812), captured from SEARCH_RES_EVT
+  bool have_hid_range{false};
+  uint16_t hid_start{0};
+  uint16_t hid_end{0};
+
+  bool tried_ccc_both_bits{false};
+
+  const NotifyPair *begin() const { return this->pairs; }
+  const NotifyPair *end() const { return this->pairs + this->pair_count; }
+
+  bool has_pair(const NotifyPair &p) const {
+    for (uint8_t i = 0; i < this->pair_count; i++) {
+      if (this->pairs[i] == p)
+        return true;
+    }
+    return false;
+  }
+  // Adds `p` unless incomplete, already known or full; false if it was not added.
+  bool add_pair(const NotifyPair &p) {
+    if (p.input_handle == 0 || p.ccc_handle == 0 || this->pair_count >= MAX_NOTIFY_PAIRS || this->has_pair(p))
+      return false;
+    this->pairs[this->pair_count++] = p;
+    return true;
+  }
+
+  bool input_is_known(uint16_t input_handle) const {
+    for (uint8_t i = 0; i < this->pair_count; i++) {
+      if (this->pairs[i].input_handle == input_handle)
+        return true;
+    }
+    return false;
+  }
+
+  CccEntry *find_ccc(uint16_t ccc_handle) {
+    for (uint8_t i = 0; i < this->ccc_count; i++) {
+      if (this->ccc[i].ccc_handle == ccc_handle)
+        return &this->ccc[i];
+    }
+    return nullptr;
+  }
+  // Entry for `ccc_handle`, added with the default value if new; nullptr when full.
+  CccEntry *ccc_entry(uint16_t ccc_handle) {
+    CccEntry *entry = this->find_ccc(ccc_handle);
+    if (entry != nullptr || this->ccc_count >= MAX_NOTIFY_PAIRS)
+      return entry;
+    entry = &this->ccc[this->ccc_count++];
+    *entry = CccEntry{};
+    entry->ccc_handle = ccc_handle;
+    return entry;
+  }
+  uint16_t desired_ccc_value(uint16_t ccc_handle) {
+    const CccEntry *entry = this->find_ccc(ccc_handle);
+    return entry != nullptr ? entry->desired : CCC_NOTIFY;
+  }
+
+  // Forgets what was written (new connection); keeps pairs and desired values.
+  void reset_ccc() {
+    for (uint8_t i = 0; i < this->ccc_count; i++) {
+      this->ccc[i].enabled = false;
+      this->ccc[i].last_attempt_ms = 0;
+    }
+    this->last_notify_ms = 0;
+    this->tried_ccc_both_bits = false;
+  }
+  void clear_pairs() {
+    this->pair_count = 0;
+    this->ccc_count = 0;
+    this->last_notify_ms = 0;
+    this->tried_ccc_both_bits = false;
+  }
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
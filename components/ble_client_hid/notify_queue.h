@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace esphome {
+namespace ble_client_hid {
+
+// Essence input reports are 2 bytes; leave room for remotes with a few more.
+static constexpr uint8_t NOTIFY_PAYLOAD_MAX = 8;
+static constexpr size_t NOTIFY_QUEUE_SIZE = 32;
+// Records decoded per loop() call; the rest wait for the next iteration.
+static constexpr uint8_t NOTIFY_DRAIN_BATCH = 8;
+
+// One notification as queued on the NOTIFY path. Fixed size, trivially copyable.
+struct NotifyRecord {
+  uint32_t t_us{0};  // arrival time (micros)
+  uint16_t handle{0};
+  uint8_t len{0};       // bytes stored in data
+  uint8_t orig_len{0};  // bytes received (saturated), > len if truncated
+  uint8_t data[NOTIFY_PAYLOAD_MAX]{};
+
+  void assign(uint16_t h, const uint8_t *value, uint16_t value_len, uint32_t now_us) {
+    this->t_us = now_us;
+    this->handle = h;
+    this->orig_len = value_len > 0xFF ? 0xFF : (uint8_t) value_len;
+    this->len = value_len > NOTIFY_PAYLOAD_MAX ? NOTIFY_PAYLOAD_MAX : (uint8_t) value_len;
+    memcpy(this->data, value, this->len);
+  }
+};
+
+// Lock-free single-producer / single-consumer ring. The producer (the NOTIFY
+// handler, or notify_hook() on the Bluedroid task with BLE_HID_NOTIFY_HOOK,
+// never both) only calls push(), the consumer (loop()) only calls pop().
+template<typename T, size_t N> class SPSCRing {
+  static_assert((N & (N - 1)) == 0, "SPSCRing capacity must be a power of two");
+
+ public:
+  bool push(const T &item) {
+    const uint32_t head = this->head_.load(std::memory_order_relaxed);
+    const uint32_t tail = this->tail_.load(std::memory_order_acquire);
+    if (head - tail >= N) {
+      this->overflows_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    this->buf_[head & (N - 1)] = item;
+    this->head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T &out) {
+    const uint32_t tail = this->tail_.load(std::memory_order_relaxed);
+    const uint32_t head = this->head_.load(std::memory_order_acquire);
+    if (head == tail)
+      return false;
+    out = this->buf_[tail & (N - 1)];
+    this->tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const {
+    return this->head_.load(std::memory_order_acquire) - this->tail_.load(std::memory_order_acquire);
+  }
+  uint32_t overflows() const { return this->overflows_.load(std::memory_order_relaxed); }
+  static constexpr size_t capacity() { return N; }
+
+ protected:
+  T buf_[N]{};
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+  std::atomic<uint32_t> overflows_{0};
+};
+
+using NotifyQueue = SPSCRing<NotifyRecord, NOTIFY_QUEUE_SIZE>;
+
+// Consumer-side measurements, reset every time they are published.
+struct NotifyStats {
+  uint32_t max_depth{0};
+  uint32_t max_latency_us{0};
+  uint64_t total_latency_us{0};
+  uint32_t records{0};
+  uint32_t reported_overflows{0};
+
+  void record_depth(uint32_t depth) {
+    if (depth > this->max_depth)
+      this->max_depth = depth;
+  }
+  void record_latency(uint32_t latency_us) {
+    if (latency_us > this->max_latency_us)
+      this->max_latency_us = latency_us;
+    this->total_latency_us += latency_us;
+    this->records++;
+  }
+  uint32_t mean_latency_us() const {
+    return this->records == 0 ? 0 : (uint32_t) (this->total_latency_us / this->records);
+  }
+  void reset_window() {
+    this->max_depth = 0;
+    this->max_latency_us = 0;
+    this->total_latency_us = 0;
+    this->records = 0;
+  }
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,69 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import number
+from esphome.const import (
+    CONF_ATTRIBUTE,
+    CONF_ENTITY_ID,
+    CONF_INITIAL_VALUE,
+    CONF_MAX_VALUE,
+    CONF_MIN_VALUE,
+    CONF_STEP,
+)
+from esphome.components import ble_client_hid
+
+
+DEPENDENCIES = ['ble_client_hid']
+
+CONF_PUBLISH_INTERVAL = "publish_interval"
+CONF_SEED = "seed"
+
+WheelNumber = ble_client_hid.ble_client_hid_ns.class_(
+    "WheelNumber", number.Number, cg.Component
+)
+
+def validate_range(config):
+    if config[CONF_MAX_VALUE] <= config[CONF_MIN_VALUE]:
+        raise cv.Invalid(f"{CONF_MAX_VALUE} must be greater than {CONF_MIN_VALUE}")
+    initial = config.get(CONF_INITIAL_VALUE, config[CONF_MIN_VALUE])
+    if not config[CONF_MIN_VALUE] <= initial <= config[CONF_MAX_VALUE]:
+        raise cv.Invalid(f"{CONF_INITIAL_VALUE} must be between {CONF_MIN_VALUE} and {CONF_MAX_VALUE}")
+    return config
+
+CONFIG_SCHEMA = cv.All(
+    number.number_schema(WheelNumber)
+    .extend(
+        {
+            cv.Optional(CONF_MIN_VALUE, default=0): cv.float_,
+            cv.Optional(CONF_MAX_VALUE, default=100): cv.float_,
+            # Amount added per wheel step (after the acceleration curve)
+            cv.Optional(CONF_STEP, default=1): cv.positive_float,
+            cv.Optional(CONF_INITIAL_VALUE): cv.float_,
+            cv.Optional(CONF_PUBLISH_INTERVAL, default="200ms"): cv.positive_time_period_milliseconds,
+            # Home Assistant entity to take the value from when the remote connects
+            cv.Optional(CONF_SEED): cv.Schema(
+                {
+                    cv.Required(CONF_ENTITY_ID): cv.entity_id,
+                    cv.Optional(CONF_ATTRIBUTE, default=""): cv.string,
+                }
+            ),
+        }
+    )
+    .extend(cv.COMPONENT_SCHEMA)
+    .extend(ble_client_hid.BLE_CLIENT_HID_SCHEMA),
+    validate_range,
+)
+
+async def to_code(config):
+    var = await number.new_number(
+        config,
+        min_value=config[CONF_MIN_VALUE],
+        max_value=config[CONF_MAX_VALUE],
+        step=config[CONF_STEP],
+    )
+    await cg.register_component(var, config)
+    cg.add(var.set_initial_value(config.get(CONF_INITIAL_VALUE, config[CONF_MIN_VALUE])))
+    cg.add(var.set_publish_interval(config[CONF_PUBLISH_INTERVAL]))
+    if CONF_SEED in config:
+        seed = config[CONF_SEED]
+        cg.add(var.set_seed_entity(seed[CONF_ENTITY_ID], seed[CONF_ATTRIBUTE]))
+    await ble_client_hid.register_wheel_number(var, config)
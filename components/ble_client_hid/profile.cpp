@@ -0,0 +1,66 @@
+#include "profile.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+uint8_t ReportDecoder::decode(uint16_t key, ControlEdge *out) {
+  const RemoteProfile &profile = *this->profile_;
+  uint8_t n = 0;
+
+  const uint16_t bits = key & profile.bit_mask;
+  uint16_t code = key & ~profile.bit_mask;
+
+  // A wheel in the code field ticks on every report that carries it.
+  const ProfileSlot *code_slot = nullptr;
+  const ProfileSlot *code_tick = nullptr;
+  if (code != profile.release_code) {
+    code_slot = profile.lookup(code);
+    if (code_slot != nullptr && profile.controls[code_slot->control].type == ControlType::WHEEL) {
+      code_tick = code_slot;
+      code = profile.release_code;
+    }
+  }
+
+  // Releases: the code-field control that changed, then bits that dropped.
+  if (code != this->prev_code_ && this->prev_code_ != profile.release_code) {
+    const ProfileSlot *prev = profile.lookup(this->prev_code_);
+    if (prev != nullptr)
+      out[n++] = ControlEdge{EdgeKind::RELEASE, prev->control, 0, prev->code};
+  }
+  const uint16_t changed = bits ^ this->prev_bits_;
+  for (uint16_t m = changed & this->prev_bits_; m != 0; m &= m - 1) {
+    const ProfileSlot &slot = profile.bit_slots[__builtin_ctz(m)];
+    if (profile.controls[slot.control].type != ControlType::WHEEL)
+      out[n++] = ControlEdge{EdgeKind::RELEASE, slot.control, 0, slot.code};
+  }
+
+  // Presses
+  if (code != this->prev_code_ && code != profile.release_code) {
+    if (code_slot != nullptr) {
+      out[n++] = ControlEdge{EdgeKind::PRESS, code_slot->control, 0, code_slot->code};
+    } else {
+      out[n++] = ControlEdge{EdgeKind::UNKNOWN, PROFILE_NO_CONTROL, 0, code};
+    }
+  }
+  for (uint16_t m = changed & bits; m != 0; m &= m - 1) {
+    const ProfileSlot &slot = profile.bit_slots[__builtin_ctz(m)];
+    if (profile.controls[slot.control].type != ControlType::WHEEL)
+      out[n++] = ControlEdge{EdgeKind::PRESS, slot.control, 0, slot.code};
+  }
+
+  // Wheel ticks: every report with a wheel bit set is one tick.
+  if (code_tick != nullptr)
+    out[n++] = ControlEdge{EdgeKind::TICK, code_tick->control, code_tick->direction, code_tick->code};
+  for (uint16_t m = bits; m != 0; m &= m - 1) {
+    const ProfileSlot &slot = profile.bit_slots[__builtin_ctz(m)];
+    if (profile.controls[slot.control].type == ControlType::WHEEL)
+      out[n++] = ControlEdge{EdgeKind::TICK, slot.control, slot.direction, slot.code};
+  }
+
+  this->prev_code_ = code;
+  this->prev_bits_ = bits;
+  return n;
+}
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+
+#include "remote_event.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+// Upper bound for buttons in any profile built into this firmware. Set by the
+// code generator from the largest configured profile.
+#ifndef BLE_CLIENT_HID_MAX_BUTTONS
+#define BLE_CLIENT_HID_MAX_BUTTONS 4
+#endif
+
+static constexpr uint8_t MAX_BUTTONS = BLE_CLIENT_HID_MAX_BUTTONS;
+static constexpr uint8_t PROFILE_NO_CONTROL = 0xFF;
+
+enum class ControlType : uint8_t { BUTTON = 0, WHEEL, TOGGLE };
+
+// How the 16-bit lookup key is taken from an input report.
+enum class ProfileKey : uint8_t {
+  RAW_BE = 0,  // first two bytes, big endian (Essence: 0x0006 = up)
+  USAGE_LE,    // first two bytes, little endian (consumer usage reports)
+};
+
+// -----------------------------------------------------------------------------
+// A remote profile: which report codes are which controls, and their action
+// names. Profiles are generated by profiles.py into const tables (flash).
+// -----------------------------------------------------------------------------
+struct ProfileControl {
+  const char *name;
+  ControlType type;
+  uint8_t index;                // button index, or toggle bit
+  const char *const *actions;  // BUTTON: per ButtonGesture; WHEEL: right, left; TOGGLE: on, off
+  const char *const *chords;   // BUTTON with a wheel in the profile: wheel right, left while held
+};
+
+// One slot of the perfect hash table, or of the per-bit table. Empty slots
+// have control == PROFILE_NO_CONTROL.
+struct ProfileSlot {
+  uint16_t code;
+  uint8_t control;
+  int8_t direction;  // wheel only: +1 right, -1 left
+};
+
+static constexpr uint8_t PROFILE_KEY_BITS = 16;
+
+// A report key has two parts. Bits in `bit_mask` belong to controls of their
+// own, one bit each, and can be set together. The remaining bits form a code
+// field holding at most one control at a time (release_code: none).
+struct RemoteProfile {
+  const char *name;
+  ProfileKey key;
+  uint16_t release_code;
+  uint16_t bit_mask;
+  const ProfileSlot *bit_slots;  // PROFILE_KEY_BITS entries, indexed by bit number
+  // slot = (code * hash_mul) >> hash_shift, collision free for this profile's codes
+  uint32_t hash_mul;
+  uint8_t hash_shift;
+  const ProfileSlot *slots;
+  const ProfileControl *controls;
+  uint8_t control_count;
+  uint8_t button_count;
+  uint8_t toggle_count;
+
+  uint16_t decode_key(const uint8_t *data) const {
+    return this->key == ProfileKey::RAW_BE ? (uint16_t) ((data[0] << 8) | data[1])
+                                           : (uint16_t) (data[0] | (data[1] << 8));
+  }
+
+  // Looks up a value of the code field.
+  const ProfileSlot *lookup(uint16_t code) const {
+    const ProfileSlot &slot = this->slots[(uint32_t) (code * this->hash_mul) >> this->hash_shift];
+    return slot.control != PROFILE_NO_CONTROL && slot.code == code ? &slot : nullptr;
+  }
+
+  // Button controls come first, in button index order.
+  const ProfileControl &button(ButtonId button) const { return this->controls[static_cast<uint8_t>(button)]; }
+  const char *button_name(ButtonId button) const {
+    return static_cast<uint8_t>(button) < this->button_count ? this->button(button).name : "unknown";
+  }
+  const char *button_chord(ButtonId button, int8_t direction) const {
+    if (static_cast<uint8_t>(button) >= this->button_count || this->button(button).chords == nullptr)
+      return nullptr;
+    return this->button(button).chords[direction > 0 ? 0 : 1];
+  }
+  const char *button_action(ButtonId button, ButtonGesture gesture) const {
+    if (static_cast<uint8_t>(button) >= this->button_count)
+      return nullptr;
+    return this->button(button).actions[static_cast<uint8_t>(gesture)];
+  }
+};
+
+// -----------------------------------------------------------------------------
+// Report decoding: diffs each report against the previous one and yields the
+// press/release edges and wheel ticks it contains.
+// -----------------------------------------------------------------------------
+enum class EdgeKind : uint8_t { RELEASE = 0, PRESS, TICK, UNKNOWN };
+
+struct ControlEdge {
+  EdgeKind kind;
+  uint8_t control;   // index into RemoteProfile::controls (PROFILE_NO_CONTROL for UNKNOWN)
+  int8_t direction;  // TICK: +1 right, -1 left
+  uint16_t code;     // the control's code or bit
+};
+
+// Every bit plus the old and the new code-field control.
+static constexpr uint8_t MAX_EDGES_PER_REPORT = PROFILE_KEY_BITS + 2;
+
+class ReportDecoder {
+ public:
+  void set_profile(const RemoteProfile *profile) {
+    this->profile_ = profile;
+    this->reset();
+  }
+  void reset() {
+    this->prev_code_ = this->profile_ != nullptr ? this->profile_->release_code : 0;
+    this->prev_bits_ = 0;
+  }
+
+  // Writes the edges of `key` to `out` (MAX_EDGES_PER_REPORT entries), releases
+  // first, and returns how many there are.
+  uint8_t decode(uint16_t key, ControlEdge *out);
+
+ protected:
+  const RemoteProfile *profile_{nullptr};
+  uint16_t prev_code_{0};
+  uint16_t prev_bits_{0};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,53 @@
+#pragma once
+
+// Generated by profiles.py - do not edit.
+
+#include "profile.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+static const char *const PROFILE_ESSENCE_ACTIONS_0[] = {"up_pressed", "up_released", "up_single", "up_double", "up_triple", "up_long", "up_repeat"};
+static const char *const PROFILE_ESSENCE_CHORDS_0[] = {"up+rotate_right", "up+rotate_left"};
+static const char *const PROFILE_ESSENCE_ACTIONS_1[] = {"down_pressed", "down_released", "down_single", "down_double", "down_triple", "down_long", "down_repeat"};
+static const char *const PROFILE_ESSENCE_CHORDS_1[] = {"down+rotate_right", "down+rotate_left"};
+static const char *const PROFILE_ESSENCE_ACTIONS_2[] = {"left_pressed", "left_released", "left_single", "left_double", "left_triple", "left_long", "left_repeat"};
+static const char *const PROFILE_ESSENCE_CHORDS_2[] = {"left+rotate_right", "left+rotate_left"};
+static const char *const PROFILE_ESSENCE_ACTIONS_3[] = {"right_pressed", "right_released", "right_single", "right_double", "right_triple", "right_long", "right_repeat"};
+static const char *const PROFILE_ESSENCE_CHORDS_3[] = {"right+rotate_right", "right+rotate_left"};
+static const char *const PROFILE_ESSENCE_ACTIONS_4[] = {"rotate_right", "rotate_left"};
+static const ProfileControl PROFILE_ESSENCE_CONTROLS[] = {
+    {"up", ControlType::BUTTON, 0, PROFILE_ESSENCE_ACTIONS_0, PROFILE_ESSENCE_CHORDS_0},
+    {"down", ControlType::BUTTON, 1, PROFILE_ESSENCE_ACTIONS_1, PROFILE_ESSENCE_CHORDS_1},
+    {"left", ControlType::BUTTON, 2, PROFILE_ESSENCE_ACTIONS_2, PROFILE_ESSENCE_CHORDS_2},
+    {"right", ControlType::BUTTON, 3, PROFILE_ESSENCE_ACTIONS_3, PROFILE_ESSENCE_CHORDS_3},
+    {"rotate", ControlType::WHEEL, 0, PROFILE_ESSENCE_ACTIONS_4, nullptr},
+};
+static const ProfileSlot PROFILE_ESSENCE_SLOTS[] = {
+    {0x0006, 0, 0},
+    {0x000b, 2, 0},
+    {0x000a, 3, 0},
+    {0x0001, 1, 0},
+};
+static const ProfileSlot PROFILE_ESSENCE_BIT_SLOTS[] = {
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x0000, PROFILE_NO_CONTROL, 0},
+    {0x4000, 4, 1},
+    {0x8000, 4, -1},
+};
+static const RemoteProfile PROFILE_ESSENCE = {"essence", ProfileKey::RAW_BE, 0x0000, 0xc000, PROFILE_ESSENCE_BIT_SLOTS, 0xdc552ce9u, 30, PROFILE_ESSENCE_SLOTS, PROFILE_ESSENCE_CONTROLS, 5, 4, 0};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,264 @@
+"""Remote profiles: report codes -> logical controls, compiled to C++ tables.
+
+A profile lists the controls of one remote model. Each control has a name, a
+type and the 16-bit code(s) it sends:
+
+    button: one code while pressed, the profile's release code on release
+    wheel:  one code per tick and direction
+    toggle: one code per press; alternates <name>_on / <name>_off
+
+With `bits: True` a control's codes are single bits of the report instead of
+values of the code field. Bit controls can be active together and alongside
+the one code-field control, e.g. the wheel turned while a button is held.
+
+compile_profile() checks a profile and finds a multiplicative perfect hash for
+its codes, so the firmware dispatches a notification with one multiply, one
+shift and one compare. render_profile() turns the result into const tables.
+
+This module has no ESPHome imports. Run it directly to regenerate the
+built-in Essence header used when no other profile is selected:
+
+    python3 components/ble_client_hid/profiles.py
+"""
+
+import os
+import re
+
+BUTTON = "button"
+WHEEL = "wheel"
+TOGGLE = "toggle"
+CONTROL_TYPES = (BUTTON, WHEEL, TOGGLE)
+
+KEY_RAW = "raw"  # first two bytes, big endian
+KEY_USAGE = "usage"  # first two bytes, little endian
+KEYS = {KEY_RAW: "ProfileKey::RAW_BE", KEY_USAGE: "ProfileKey::USAGE_LE"}
+
+# Must match ButtonGesture in remote_event.h.
+BUTTON_GESTURES = ("pressed", "released", "single", "double", "triple", "long", "repeat")
+
+MAX_CONTROLS = 254
+MAX_TOGGLES = 32
+
+# Essence Remote, as observed:
+# 0x0006 = Up, 0x0001 = Down, 0x000B = Left, 0x000A = Right, 0x0000 = release,
+# 0x4000 / 0x8000 = wheel right / left
+ESSENCE = {
+    "name": "essence",
+    "key": KEY_RAW,
+    "release": 0x0000,
+    "controls": [
+        {"name": "up", "type": BUTTON, "code": 0x0006},
+        {"name": "down", "type": BUTTON, "code": 0x0001},
+        {"name": "left", "type": BUTTON, "code": 0x000B},
+        {"name": "right", "type": BUTTON, "code": 0x000A},
+        {"name": "rotate", "type": WHEEL, "right": 0x4000, "left": 0x8000, "bits": True},
+    ],
+}
+
+BUILTIN_PROFILES = {
+    "essence": ESSENCE,
+}
+
+DEFAULT_PROFILE = "essence"
+
+_NAME_RE = re.compile(r"^[a-z][a-z0-9_]*$")
+
+
+class ProfileError(Exception):
+    pass
+
+
+def _codes(control):
+    if control["type"] == WHEEL:
+        return [(control["right"], 1), (control["left"], -1)]
+    return [(control["code"], 0)]
+
+
+def find_hash(codes):
+    """Smallest table (power of two) and odd multiplier with no collisions.
+
+    Works for any keys below 2**32; gestures.py uses it for (state, token) keys.
+    """
+    bits = max(1, (len(codes) - 1).bit_length())
+    for table_bits in range(bits, bits + 4):
+        shift = 32 - table_bits
+        mul = 0x9E3779B1
+        for _ in range(20000):
+            slots = {((code * mul) & 0xFFFFFFFF) >> shift for code in codes}
+            if len(slots) == len(codes):
+                return mul, shift
+            mul = (mul + 0x6A09E668) & 0xFFFFFFFF | 1
+    raise ProfileError("no perfect hash found for the profile's codes")
+
+
+def compile_profile(profile):
+    """Validates `profile` and returns it with buttons first plus its hash table."""
+    name = profile["name"]
+    if not _NAME_RE.match(name):
+        raise ProfileError(f"profile name '{name}' must be lower case letters, digits and _")
+    controls = list(profile["controls"])
+    if not controls or len(controls) > MAX_CONTROLS:
+        raise ProfileError(f"profile '{name}' needs 1..{MAX_CONTROLS} controls")
+
+    ordered = [c for c in controls if c["type"] == BUTTON]
+    ordered += [c for c in controls if c["type"] == WHEEL]
+    ordered += [c for c in controls if c["type"] == TOGGLE]
+
+    bit_mask = 0
+    for control in ordered:
+        if control.get("bits"):
+            for code, _ in _codes(control):
+                if code == 0 or code & (code - 1):
+                    raise ProfileError(f"control '{control['name']}': 0x{code:04x} is not a single bit")
+                bit_mask |= code
+    if profile["release"] & bit_mask:
+        raise ProfileError(f"profile '{name}': release code overlaps bit controls")
+
+    seen_names = set()
+    seen_codes = {}
+    for control in ordered:
+        cname = control["name"]
+        if control["type"] not in CONTROL_TYPES:
+            raise ProfileError(f"control '{cname}': unknown type '{control['type']}'")
+        if not _NAME_RE.match(cname):
+            raise ProfileError(f"control name '{cname}' must be lower case letters, digits and _")
+        if cname in seen_names:
+            raise ProfileError(f"control '{cname}' defined twice")
+        seen_names.add(cname)
+        for code, _ in _codes(control):
+            if not 0 <= code <= 0xFFFF:
+                raise ProfileError(f"control '{cname}': code 0x{code:x} is not 16 bit")
+            if code == profile["release"]:
+                raise ProfileError(f"control '{cname}': code 0x{code:04x} is the release code")
+            if code in seen_codes:
+                raise ProfileError(f"code 0x{code:04x} used by '{seen_codes[code]}' and '{cname}'")
+            if not control.get("bits") and code & bit_mask:
+                raise ProfileError(f"control '{cname}': code 0x{code:04x} overlaps bit controls")
+            seen_codes[code] = cname
+
+    if sum(1 for c in ordered if c["type"] == WHEEL) > 1:
+        raise ProfileError(f"profile '{name}': at most one wheel")
+    toggles = [c for c in ordered if c["type"] == TOGGLE]
+    if len(toggles) > MAX_TOGGLES:
+        raise ProfileError(f"profile '{name}': at most {MAX_TOGGLES} toggles")
+
+    entries = []
+    bit_slots = [None] * 16
+    for index, control in enumerate(ordered):
+        for code, direction in _codes(control):
+            if control.get("bits"):
+                bit_slots[code.bit_length() - 1] = (code, index, direction)
+            else:
+                entries.append((code, index, direction))
+    mul, shift = find_hash([e[0] for e in entries])
+    slots = [None] * (1 << (32 - shift))
+    for code, index, direction in entries:
+        slots[((code * mul) & 0xFFFFFFFF) >> shift] = (code, index, direction)
+
+    return {
+        "name": name,
+        "key": profile["key"],
+        "release": profile["release"],
+        "bit_mask": bit_mask,
+        "bit_slots": bit_slots,
+        "controls": ordered,
+        "buttons": [c["name"] for c in ordered if c["type"] == BUTTON],
+        "toggle_count": len(toggles),
+        "hash_mul": mul,
+        "hash_shift": shift,
+        "slots": slots,
+    }
+
+
+def _action_names(control):
+    cname = control["name"]
+    if control["type"] == BUTTON:
+        return [f"{cname}_{g}" for g in BUTTON_GESTURES]
+    if control["type"] == WHEEL:
+        return [f"{cname}_right", f"{cname}_left"]
+    return [f"{cname}_on", f"{cname}_off"]
+
+
+def action_names(compiled):
+    """Every action the profile's controls can send, chords included."""
+    names = []
+    wheel = next((c for c in compiled["controls"] if c["type"] == WHEEL), None)
+    for control in compiled["controls"]:
+        names += _action_names(control)
+        if control["type"] == BUTTON and wheel is not None:
+            names += [f"{control['name']}+{a}" for a in _action_names(wheel)]
+    return names
+
+
+def profile_symbol(name):
+    return f"PROFILE_{name.upper()}"
+
+
+def render_profile(compiled):
+    """C++ definition of the profile's tables (inside namespace ble_client_hid)."""
+    sym = profile_symbol(compiled["name"])
+    lines = []
+    toggle = 0
+    control_rows = []
+    wheel = next((c for c in compiled["controls"] if c["type"] == WHEEL), None)
+    for index, control in enumerate(compiled["controls"]):
+        actions = ", ".join(f'"{a}"' for a in _action_names(control))
+        lines.append(f"static const char *const {sym}_ACTIONS_{index}[] = {{{actions}}};")
+        chord = "nullptr"
+        if control["type"] == BUTTON and wheel is not None:
+            # wheel turned while this button is held: <button>+<wheel>_right / _left
+            chords = ", ".join(f'"{control["name"]}+{a}"' for a in _action_names(wheel))
+            lines.append(f"static const char *const {sym}_CHORDS_{index}[] = {{{chords}}};")
+            chord = f"{sym}_CHORDS_{index}"
+        if control["type"] == BUTTON:
+            ctype, cindex = "ControlType::BUTTON", index
+        elif control["type"] == WHEEL:
+            ctype, cindex = "ControlType::WHEEL", 0
+        else:
+            ctype, cindex = "ControlType::TOGGLE", toggle
+            toggle += 1
+        control_rows.append(f'    {{"{control["name"]}", {ctype}, {cindex}, {sym}_ACTIONS_{index}, {chord}}},')
+
+    lines.append(f"static const ProfileControl {sym}_CONTROLS[] = {{")
+    lines += control_rows
+    lines.append("};")
+    for table, slots in (("SLOTS", compiled["slots"]), ("BIT_SLOTS", compiled["bit_slots"])):
+        lines.append(f"static const ProfileSlot {sym}_{table}[] = {{")
+        for slot in slots:
+            if slot is None:
+                lines.append("    {0x0000, PROFILE_NO_CONTROL, 0},")
+            else:
+                lines.append(f"    {{0x{slot[0]:04x}, {slot[1]}, {slot[2]}}},")
+        lines.append("};")
+    lines.append(
+        f'static const RemoteProfile {sym} = {{"{compiled["name"]}", {KEYS[compiled["key"]]}, '
+        f'0x{compiled["release"]:04x}, 0x{compiled["bit_mask"]:04x}, {sym}_BIT_SLOTS, '
+        f'0x{compiled["hash_mul"]:08x}u, {compiled["hash_shift"]}, '
+        f'{sym}_SLOTS, {sym}_CONTROLS, {len(compiled["controls"])}, {len(compiled["buttons"])}, '
+        f'{compiled["toggle_count"]}}};'
+    )
+    return "\n".join(lines)
+
+
+def render_header(compiled):
+    return (
+        "#pragma once\n"
+        "\n"
+        "// Generated by profiles.py - do not edit.\n"
+        "\n"
+        '#include "profile.h"\n'
+        "\n"
+        "namespace esphome {\n"
+        "namespace ble_client_hid {\n"
+        "\n"
+        f"{render_profile(compiled)}\n"
+        "\n"
+        "}  // namespace ble_client_hid\n"
+        "}  // namespace esphome\n"
+    )
+
+
+if __name__ == "__main__":
+    here = os.path.dirname(os.path.abspath(__file__))
+    with open(os.path.join(here, "profile_essence.h"), "w") as header_file:
+        header_file.write(render_header(compile_profile(ESSENCE)))
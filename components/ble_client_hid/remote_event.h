@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace ble_client_hid {
+
+// -----------------------------------------------------------------------------
+// Buttons and gestures. Action names come from the remote profile (profile.h).
+// -----------------------------------------------------------------------------
+// Index of a button control in the active profile.
+enum class ButtonId : uint8_t { NONE = 255 };
+
+enum class ButtonGesture : uint8_t { PRESSED = 0, RELEASED, SINGLE, DOUBLE, TRIPLE, LONG, REPEAT, COUNT };
+
+static constexpr uint8_t BUTTON_GESTURE_COUNT = static_cast<uint8_t>(ButtonGesture::COUNT);
+
+// -----------------------------------------------------------------------------
+// Event record handed from decoding to the API / sensor sink.
+// Fixed layout, no owning members: `action` always points at a string literal,
+// everything else is formatted by the sink into stack buffers.
+// -----------------------------------------------------------------------------
+struct RemoteEvent {
+  const char *action{nullptr};  // nullptr: unknown report, named "raw_<raw>"
+  uint16_t raw{0};
+  bool has_raw{false};
+  int8_t clicks{-1};
+  uint16_t steps{0};  // wheel events: ticks merged into this event
+  int16_t delta{0};   // wheel events: signed steps scaled by the acceleration curve
+  uint16_t gesture{0};       // pattern events: sequence number shared by one gesture (0: none)
+  bool provisional{false};  // speculative *_single that a longer pattern may supersede
+  uint16_t repeat{0};        // *_repeat events: 1-based index within the hold
+};
+
+static constexpr size_t HEX4_BUF_SIZE = 5;        // 4 hex digits + NUL
+static constexpr size_t ACTION_NAME_BUF_SIZE = 9;  // "raw_" + 4 hex digits + NUL
+static constexpr size_t INT_BUF_SIZE = 12;        // "-2147483648" + NUL
+
+inline char *format_hex4(char *buf, uint16_t v) {
+  static const char DIGITS[] = "0123456789abcdef";
+  buf[0] = DIGITS[(v >> 12) & 0xF];
+  buf[1] = DIGITS[(v >> 8) & 0xF];
+  buf[2] = DIGITS[(v >> 4) & 0xF];
+  buf[3] = DIGITS[v & 0xF];
+  buf[4] = '\0';
+  return buf;
+}
+
+inline char *format_int(char *buf, int32_t v) {
+  char tmp[INT_BUF_SIZE];
+  uint32_t u = v < 0 ? 0u - static_cast<uint32_t>(v) : static_cast<uint32_t>(v);
+  size_t n = 0;
+  do {
+    tmp[n++] = static_cast<char>('0' + (u % 10));
+    u /= 10;
+  } while (u != 0);
+  size_t i = 0;
+  if (v < 0)
+    buf[i++] = '-';
+  while (n > 0)
+    buf[i++] = tmp[--n];
+  buf[i] = '\0';
+  return buf;
+}
+
+// Returns the event's action name; `buf` (ACTION_NAME_BUF_SIZE) backs the raw_<hex> case.
+inline const char *event_action_name(const RemoteEvent &ev, char *buf) {
+  if (ev.action != nullptr)
+    return ev.action;
+  buf[0] = 'r';
+  buf[1] = 'a';
+  buf[2] = 'w';
+  buf[3] = '_';
+  format_hex4(buf + 4, ev.raw);
+  return buf;
+}
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace ble_client_hid {
+
+struct ScanParams {
+  uint32_t interval_ms{0};
+  uint32_t window_ms{0};
+
+  bool operator==(const ScanParams &o) const { return interval_ms == o.interval_ms && window_ms == o.window_ms; }
+  bool operator!=(const ScanParams &o) const { return !(*this == o); }
+};
+
+// -----------------------------------------------------------------------------
+// Scan duty cycle: a high duty burst while a remote is likely to advertise
+// (just disconnected, or at boot), a low duty scan otherwise. The tracker is
+// shared by all remotes, so one instance serves all of them.
+// -----------------------------------------------------------------------------
+class ScanDuty {
+ public:
+  void configure(uint32_t burst_ms, ScanParams burst, ScanParams idle) {
+    this->enabled_ = true;
+    this->burst_ms_ = burst_ms;
+    this->burst_ = burst;
+    this->idle_ = idle;
+  }
+  bool is_enabled() const { return this->enabled_; }
+  uint32_t burst_ms() const { return this->burst_ms_; }
+  const ScanParams &burst_params() const { return this->burst_; }
+  const ScanParams &idle_params() const { return this->idle_; }
+
+  // Scan hard until `now_ms` + burst_ms; extends a burst already running.
+  void burst(uint32_t now_ms) {
+    if (!this->enabled_)
+      return;
+    this->bursting_ = true;
+    this->burst_until_ms_ = now_ms + this->burst_ms_;
+  }
+
+  // Parameters wanted at `now_ms`. True if they differ from what was last
+  // returned, i.e. the scanner has to be reconfigured.
+  bool update(uint32_t now_ms, ScanParams &out) {
+    if (!this->enabled_)
+      return false;
+    if (this->bursting_ && (int32_t) (now_ms - this->burst_until_ms_) >= 0)
+      this->bursting_ = false;
+    out = this->bursting_ ? this->burst_ : this->idle_;
+    if (this->applied_valid_ && out == this->applied_)
+      return false;
+    this->applied_ = out;
+    this->applied_valid_ = true;
+    return true;
+  }
+
+ protected:
+  bool enabled_{false};
+  uint32_t burst_ms_{0};
+  ScanParams burst_{};
+  ScanParams idle_{};
+  bool bursting_{false};
+  uint32_t burst_until_ms_{0};
+  ScanParams applied_{};
+  bool applied_valid_{false};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -6,9 +6,13 @@ from esphome.const import (
     UNIT_PERCENT,
     DEVICE_CLASS_BATTERY,
     STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
     UNIT_EMPTY,
     DEVICE_CLASS_EMPTY,
     STATE_CLASS_NONE,
+    UNIT_MICROSECOND,
+    UNIT_MILLISECOND,
+    ENTITY_CATEGORY_DIAGNOSTIC,
 )
 from esphome.components import ble_client_hid
 
@@ -17,6 +21,12 @@ DEPENDENCIES = ['ble_client_hid']
 
 TYPE_BATTERY = "battery"
 TYPE_LAST_EVENT_VALUE = "last_event_value"
+TYPE_NOTIFY_QUEUE_DEPTH = "notify_queue_depth"
+TYPE_NOTIFY_LATENCY = "notify_latency"
+TYPE_NOTIFY_OVERFLOWS = "notify_overflows"
+TYPE_MULTI_PRESS_WINDOW = "multi_press_window"
+TYPE_WAKE_LATENCY = "wake_latency"
+TYPE_CONNECTION_INTERVAL = "connection_interval"
 
 BatterySensor = sensor.sensor_ns.class_(
     "Sensor"
@@ -26,6 +36,10 @@ LastEventValueSensor = sensor.sensor_ns.class_(
     "Sensor"
 )
 
+DiagnosticSensor = sensor.sensor_ns.class_(
+    "Sensor"
+)
+
 CONFIG_SCHEMA = cv.All(
     cv.typed_schema(
         {
@@ -45,6 +59,59 @@ CONFIG_SCHEMA = cv.All(
                 state_class=STATE_CLASS_NONE,
             )
             .extend(ble_client_hid.BLE_CLIENT_HID_SCHEMA),
+            # Highest notify queue depth seen since the last publish
+            TYPE_NOTIFY_QUEUE_DEPTH: sensor.sensor_schema(
+                DiagnosticSensor,
+                unit_of_measurement=UNIT_EMPTY,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            )
+            .extend(ble_client_hid.BLE_CLIENT_HID_SCHEMA),
+            # Worst enqueue-to-emit latency since the last publish
+            TYPE_NOTIFY_LATENCY: sensor.sensor_schema(
+                DiagnosticSensor,
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            )
+            .extend(ble_client_hid.BLE_CLIENT_HID_SCHEMA),
+            TYPE_NOTIFY_OVERFLOWS: sensor.sensor_schema(
+                DiagnosticSensor,
+                unit_of_measurement=UNIT_EMPTY,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            )
+            .extend(ble_client_hid.BLE_CLIENT_HID_SCHEMA),
+            # Current adaptive multi-press window (needs adaptive_multi_press)
+            TYPE_MULTI_PRESS_WINDOW: sensor.sensor_schema(
+                DiagnosticSensor,
+                unit_of_measurement=UNIT_MILLISECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            )
+            .extend(ble_client_hid.BLE_CLIENT_HID_SCHEMA),
+            # Advertisement seen to first decoded event, per wake of the connected remote
+            TYPE_WAKE_LATENCY: sensor.sensor_schema(
+                DiagnosticSensor,
+                unit_of_measurement=UNIT_MILLISECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            )
+            .extend(ble_client_hid.BLE_CLIENT_HID_SCHEMA),
+            # Interval negotiated with the remote, on every update
+            TYPE_CONNECTION_INTERVAL: sensor.sensor_schema(
+                DiagnosticSensor,
+                unit_of_measurement=UNIT_MILLISECOND,
+                accuracy_decimals=2,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            )
+            .extend(ble_client_hid.BLE_CLIENT_HID_SCHEMA),
         },
     ),
 )
@@ -57,9 +124,45 @@ async def last_event_value_sensor_to_code(config):
     var = await sensor.new_sensor(config)
     await ble_client_hid.register_last_event_value_sensor(var, config)
 
+async def notify_queue_depth_sensor_to_code(config):
+    var = await sensor.new_sensor(config)
+    await ble_client_hid.register_notify_queue_depth_sensor(var, config)
+
+async def notify_latency_sensor_to_code(config):
+    var = await sensor.new_sensor(config)
+    await ble_client_hid.register_notify_latency_sensor(var, config)
+
+async def notify_overflows_sensor_to_code(config):
+    var = await sensor.new_sensor(config)
+    await ble_client_hid.register_notify_overflows_sensor(var, config)
+
+async def multi_press_window_sensor_to_code(config):
+    var = await sensor.new_sensor(config)
+    await ble_client_hid.register_multi_press_window_sensor(var, config)
+
+async def wake_latency_sensor_to_code(config):
+    var = await sensor.new_sensor(config)
+    await ble_client_hid.register_wake_latency_sensor(var, config)
+
+async def connection_interval_sensor_to_code(config):
+    var = await sensor.new_sensor(config)
+    await ble_client_hid.register_connection_interval_sensor(var, config)
+
 async def to_code(config):
     if config[CONF_TYPE] == TYPE_BATTERY:
         await battery_sensor_to_code(config)
     elif config[CONF_TYPE] == TYPE_LAST_EVENT_VALUE:
         await last_event_value_sensor_to_code(config)
+    elif config[CONF_TYPE] == TYPE_NOTIFY_QUEUE_DEPTH:
+        await notify_queue_depth_sensor_to_code(config)
+    elif config[CONF_TYPE] == TYPE_NOTIFY_LATENCY:
+        await notify_latency_sensor_to_code(config)
+    elif config[CONF_TYPE] == TYPE_NOTIFY_OVERFLOWS:
+        await notify_overflows_sensor_to_code(config)
+    elif config[CONF_TYPE] == TYPE_MULTI_PRESS_WINDOW:
+        await multi_press_window_sensor_to_code(config)
+    elif config[CONF_TYPE] == TYPE_WAKE_LATENCY:
+        await wake_latency_sensor_to_code(config)
+    elif config[CONF_TYPE] == TYPE_CONNECTION_INTERVAL:
+        await connection_interval_sensor_to_code(config)
     
\ No newline at end of file
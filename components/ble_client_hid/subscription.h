@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "notify_pairs.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+static constexpr uint8_t SUBSCRIBE_MAX_OPEN_STEPS = 6;
+
+// -----------------------------------------------------------------------------
+// When CCC writes and register-for-notify calls go out on a new connection.
+// The default is what the component has always done; host/sim_wake compares
+// alternatives against a simulated remote.
+// -----------------------------------------------------------------------------
+struct SubscribeStrategy {
+  // Writes after OPEN (ms), from the cached or fallback pairs. Retries skip a
+  // CCC that was written less than min_interval_ms ago.
+  uint32_t open_steps_ms[SUBSCRIBE_MAX_OPEN_STEPS]{80, 600, 2000};
+  uint8_t open_step_count{3};
+  bool on_search_complete{true};  // after discovery, with the pairs it found
+  bool on_auth_complete{true};    // forced, some remotes only accept writes once encrypted
+  // No notification this long after OPEN: write CCC=0x0003 once (0: never).
+  uint32_t both_bits_after_ms{2000};
+  uint32_t min_interval_ms{5000};
+};
+
+// CCC value write (`ccc_handle`, value); true if the stack accepted the request.
+using WriteCccFunction = std::function<bool(uint16_t ccc_handle, uint16_t value, const char *reason)>;
+// Local registration for notifications on `input_handle`.
+using RegisterNotifyFunction = std::function<bool(uint16_t input_handle, const char *reason)>;
+
+// -----------------------------------------------------------------------------
+// Subscribes one remote's notify pairs (RemoteBleState) following a
+// SubscribeStrategy. Transport independent: the component forwards the GATT
+// client events and runs loop(); the GATT calls go through the two functions.
+// -----------------------------------------------------------------------------
+class NotifySubscriber {
+ public:
+  void set_state(RemoteBleState *state) { this->state_ = state; }
+  void set_strategy(const SubscribeStrategy &strategy) { this->strategy_ = strategy; }
+  const SubscribeStrategy &strategy() const { return this->strategy_; }
+  void set_write_ccc_function(WriteCccFunction fn) { this->write_ccc_ = std::move(fn); }
+  void set_register_function(RegisterNotifyFunction fn) { this->register_ = std::move(fn); }
+
+  void on_open(uint32_t now_ms) {
+    this->open_ = true;
+    this->open_ms_ = now_ms;
+    this->next_step_ = 0;
+  }
+  void on_search_complete(uint32_t now_ms) {
+    if (this->strategy_.on_search_complete)
+      this->enable_all("search_complete", false, now_ms);
+  }
+  void on_auth_complete(uint32_t now_ms) {
+    if (this->strategy_.on_auth_complete)
+      this->enable_all("auth_complete", true, now_ms);
+  }
+  void on_notify(uint32_t now_ms) { this->state_->last_notify_ms = now_ms; }
+  void on_disconnect() {
+    this->open_ = false;
+    this->state_->reset_ccc();
+  }
+
+  // Runs the post-OPEN steps that are due.
+  void loop(uint32_t now_ms) {
+    if (!this->open_)
+      return;
+    const uint32_t since_open = now_ms - this->open_ms_;
+    while (this->next_step_ < this->strategy_.open_step_count &&
+           since_open >= this->strategy_.open_steps_ms[this->next_step_]) {
+      this->next_step_++;
+      this->enable_all(this->next_step_ == 1 ? "post_open_fast" : "open_retry", false, now_ms);
+    }
+    if (this->strategy_.both_bits_after_ms > 0 && since_open >= this->strategy_.both_bits_after_ms &&
+        this->state_->last_notify_ms == 0 && !this->state_->tried_ccc_both_bits) {
+      // Without changing the desired values: notify and indicate bits together.
+      this->state_->tried_ccc_both_bits = true;
+      for (const auto &p : *this->state_)
+        this->write_and_register_(p, CCC_NOTIFY | CCC_INDICATE, true, "ccc_both_bits_fallback", now_ms);
+    }
+  }
+
+  void enable_all(const char *reason, bool force, uint32_t now_ms) {
+    for (const auto &p : *this->state_) {
+      const CccEntry *entry = this->state_->find_ccc(p.ccc_handle);
+      this->write_and_register_(p, entry != nullptr ? entry->desired : CCC_NOTIFY, force, reason, now_ms);
+    }
+  }
+
+ protected:
+  void write_and_register_(const NotifyPair &p, uint16_t value, bool force, const char *reason, uint32_t now_ms) {
+    CccEntry *entry = this->state_->ccc_entry(p.ccc_handle);
+    if (entry == nullptr)
+      return;
+    if (!force && entry->enabled && now_ms - entry->last_attempt_ms < this->strategy_.min_interval_ms)
+      return;
+    entry->last_attempt_ms = now_ms;
+    if (this->write_ccc_ && this->write_ccc_(p.ccc_handle, value, reason))
+      entry->enabled = true;
+    if (this->register_)
+      this->register_(p.input_handle, reason);
+  }
+
+  RemoteBleState *state_{nullptr};
+  SubscribeStrategy strategy_{};
+  WriteCccFunction write_ccc_;
+  RegisterNotifyFunction register_;
+  bool open_{false};
+  uint32_t open_ms_{0};
+  uint8_t next_step_{0};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -1,11 +1,15 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import text_sensor
+from esphome.const import CONF_TYPE
 from esphome.components import ble_client_hid
 
 
 DEPENDENCIES = ['ble_client_hid']
 
+TYPE_LAST_EVENT = "last_event"
+TYPE_MODE = "mode"
+
 TextSensor = text_sensor.text_sensor_ns.class_(
     "TextSensor"
 )
@@ -14,16 +18,27 @@ TextSensor = text_sensor.text_sensor_ns.class_(
 # with text_sensor.text_sensor_schema(TextSensor) to comply with ESPHome 2025.11.0 changes
 # Reference: https://developers.esphome.io/blog/2025/05/14/_schema-deprecations/
 CONFIG_SCHEMA = cv.All(
-    text_sensor.text_sensor_schema(
-        TextSensor
-    ).extend(
+    cv.typed_schema(
         {
-            cv.GenerateID(): cv.declare_id(TextSensor)
-        }
-    )
-    .extend(ble_client_hid.BLE_CLIENT_HID_SCHEMA)
+            TYPE_LAST_EVENT: text_sensor.text_sensor_schema(
+                TextSensor
+            )
+            .extend(ble_client_hid.BLE_CLIENT_HID_SCHEMA),
+            # Current mode (needs `modes:` on the remote)
+            TYPE_MODE: text_sensor.text_sensor_schema(
+                TextSensor,
+                icon="mdi:layers",
+            )
+            .extend(ble_client_hid.BLE_CLIENT_HID_SCHEMA),
+        },
+        # Configs from before `type:` existed are the last event sensor.
+        default_type=TYPE_LAST_EVENT,
+    ),
 )
 
 async def to_code(config):
     var = await text_sensor.new_text_sensor(config)
-    await ble_client_hid.register_last_event_usage_text_sensor(var, config)
+    if config[CONF_TYPE] == TYPE_MODE:
+        await ble_client_hid.register_mode_text_sensor(var, config)
+    else:
+        await ble_client_hid.register_last_event_usage_text_sensor(var, config)
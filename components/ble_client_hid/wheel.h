@@ -0,0 +1,261 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace ble_client_hid {
+
+// Fixed-point factor: 256 == 1.0
+static constexpr uint32_t WHEEL_FACTOR_ONE = 256;
+static constexpr uint8_t WHEEL_VELOCITY_SAMPLES = 8;
+static constexpr uint8_t WHEEL_TABLE_MAX_POINTS = 8;
+
+// A run of wheel ticks in one direction, ready to be emitted as one event.
+struct WheelFlush {
+  int8_t direction{0};  // +1 right, -1 left
+  uint16_t steps{0};
+  int16_t delta{0};  // signed, scaled by the acceleration curve
+};
+
+// -----------------------------------------------------------------------------
+// Angular velocity estimate over a short sliding window of tick timestamps.
+// -----------------------------------------------------------------------------
+class WheelVelocity {
+ public:
+  void set_window_us(uint32_t window_us) { this->window_us_ = window_us; }
+  uint32_t get_window_us() const { return this->window_us_; }
+
+  // Records a tick and returns the current speed in ticks per second.
+  uint32_t add_tick(uint32_t t_us) {
+    this->samples_[this->next_] = t_us;
+    this->next_ = (this->next_ + 1) % WHEEL_VELOCITY_SAMPLES;
+    if (this->count_ < WHEEL_VELOCITY_SAMPLES)
+      this->count_++;
+
+    // Walk back from the newest sample while it is inside the window.
+    uint8_t n = 1;
+    uint32_t oldest = t_us;
+    for (uint8_t i = 1; i < this->count_; i++) {
+      const uint32_t t = this->samples_[(this->next_ + WHEEL_VELOCITY_SAMPLES - 1 - i) % WHEEL_VELOCITY_SAMPLES];
+      if (t_us - t > this->window_us_)
+        break;
+      oldest = t;
+      n++;
+    }
+    const uint32_t span = t_us - oldest;
+    if (n < 2 || span == 0)
+      return 0;
+    return (uint32_t) ((uint64_t) (n - 1) * 1000000u / span);
+  }
+
+  void reset() { this->count_ = 0; }
+
+ protected:
+  uint32_t window_us_{150000};
+  uint32_t samples_[WHEEL_VELOCITY_SAMPLES]{};
+  uint8_t next_{0};
+  uint8_t count_{0};
+};
+
+// -----------------------------------------------------------------------------
+// Acceleration curve: speed (ticks/s) -> step factor (Q8). Integer math only.
+// -----------------------------------------------------------------------------
+enum class WheelCurve : uint8_t { NONE = 0, LINEAR, POWER, TABLE };
+
+static constexpr const char *const WHEEL_CURVE_NAMES[] = {"none", "linear", "power", "table"};
+
+class WheelAcceleration {
+ public:
+  void set_curve(WheelCurve curve) { this->curve_ = curve; }
+  void set_speed_range(uint32_t min_speed, uint32_t max_speed) {
+    this->min_speed_ = min_speed;
+    this->max_speed_ = max_speed > min_speed ? max_speed : min_speed + 1;
+  }
+  void set_max_factor(uint32_t max_factor_q8) {
+    this->max_factor_q8_ = max_factor_q8 < WHEEL_FACTOR_ONE ? WHEEL_FACTOR_ONE : max_factor_q8;
+  }
+  void set_exponent(uint8_t exponent) { this->exponent_ = exponent == 0 ? 1 : exponent; }
+  // Points must be added in increasing speed order.
+  void add_point(uint32_t speed, uint32_t factor_q8) {
+    if (this->point_count_ >= WHEEL_TABLE_MAX_POINTS)
+      return;
+    this->points_[this->point_count_].speed = speed;
+    this->points_[this->point_count_].factor_q8 = factor_q8;
+    this->point_count_++;
+  }
+  WheelCurve get_curve() const { return this->curve_; }
+
+  uint32_t factor_q8(uint32_t speed) const {
+    switch (this->curve_) {
+      case WheelCurve::LINEAR:
+        return this->scale_(this->position_q16_(speed));
+      case WheelCurve::POWER: {
+        const uint32_t x = this->position_q16_(speed);
+        uint32_t y = x;
+        for (uint8_t i = 1; i < this->exponent_; i++)
+          y = (uint32_t) (((uint64_t) y * x) >> 16);
+        return this->scale_(y);
+      }
+      case WheelCurve::TABLE:
+        return this->table_(speed);
+      case WheelCurve::NONE:
+      default:
+        return WHEEL_FACTOR_ONE;
+    }
+  }
+
+ protected:
+  struct Point {
+    uint32_t speed;
+    uint32_t factor_q8;
+  };
+
+  // Where `speed` sits between min and max speed, 0..65536.
+  uint32_t position_q16_(uint32_t speed) const {
+    if (speed <= this->min_speed_)
+      return 0;
+    if (speed >= this->max_speed_)
+      return 65536;
+    return (uint32_t) (((uint64_t) (speed - this->min_speed_) << 16) / (this->max_speed_ - this->min_speed_));
+  }
+
+  uint32_t scale_(uint32_t position_q16) const {
+    return WHEEL_FACTOR_ONE +
+           (uint32_t) (((uint64_t) (this->max_factor_q8_ - WHEEL_FACTOR_ONE) * position_q16) >> 16);
+  }
+
+  uint32_t table_(uint32_t speed) const {
+    if (this->point_count_ == 0)
+      return WHEEL_FACTOR_ONE;
+    if (speed <= this->points_[0].speed)
+      return this->points_[0].factor_q8;
+    for (uint8_t i = 1; i < this->point_count_; i++) {
+      const Point &a = this->points_[i - 1];
+      const Point &b = this->points_[i];
+      if (speed > b.speed)
+        continue;
+      if (b.speed == a.speed)
+        return b.factor_q8;
+      const int64_t df = (int64_t) b.factor_q8 - (int64_t) a.factor_q8;
+      return (uint32_t) ((int64_t) a.factor_q8 + df * (int64_t) (speed - a.speed) / (int64_t) (b.speed - a.speed));
+    }
+    return this->points_[this->point_count_ - 1].factor_q8;
+  }
+
+  WheelCurve curve_{WheelCurve::NONE};
+  uint32_t min_speed_{5};
+  uint32_t max_speed_{40};
+  uint32_t max_factor_q8_{4 * WHEEL_FACTOR_ONE};
+  uint8_t exponent_{2};
+  Point points_[WHEEL_TABLE_MAX_POINTS]{};
+  uint8_t point_count_{0};
+};
+
+// Merges wheel ticks into fewer events.
+//
+// Ticks decoded in the same loop() batch always merge. With a window > 0 the
+// first tick after idle still goes out at the end of its batch, and further
+// ticks in the same direction are held until the window closes, then sent as
+// one event with their step count. A direction change flushes at once.
+//
+// Every tick is weighted by the acceleration curve at the speed measured when
+// it arrived; fractions of a step carry over to the next event of the run.
+class WheelCoalescer {
+ public:
+  void set_window_ms(uint32_t window_ms) { this->window_ms_ = window_ms; }
+  uint32_t get_window_ms() const { return this->window_ms_; }
+  WheelVelocity &velocity() { return this->velocity_; }
+  WheelAcceleration &acceleration() { return this->acceleration_; }
+
+  // Adds one tick that arrived at `t_us`. Returns true with `out` set if it
+  // flushed a run in the other direction.
+  bool add_tick(int8_t direction, uint32_t t_us, WheelFlush &out) {
+    bool flushed = false;
+    if (direction != this->pending_direction_) {
+      if (this->pending_steps_ > 0)
+        flushed = this->take_(out);
+      // The new direction starts like the first tick after idle.
+      this->window_open_ = false;
+      this->velocity_.reset();
+      this->remainder_q8_ = 0;
+    }
+    // After a pause, a left-over fraction from the previous turn no longer applies.
+    if (t_us - this->last_tick_us_ > this->velocity_.get_window_us())
+      this->remainder_q8_ = 0;
+    this->last_tick_us_ = t_us;
+
+    this->pending_direction_ = direction;
+    if (this->pending_steps_ < UINT16_MAX)
+      this->pending_steps_++;
+    this->pending_q8_ += this->acceleration_.factor_q8(this->velocity_.add_tick(t_us));
+    return flushed;
+  }
+
+  // Call after each loop() batch. Sends the run if no window is holding it.
+  bool end_batch(uint32_t now_ms, WheelFlush &out) {
+    if (this->pending_steps_ == 0 || (this->window_open_ && this->window_ms_ > 0))
+      return false;
+    if (this->window_ms_ > 0) {
+      this->window_open_ = true;
+      this->deadline_ms_ = now_ms + this->window_ms_;
+    }
+    return this->take_(out);
+  }
+
+  // Call every loop(). Sends what the window collected once it closes.
+  bool poll(uint32_t now_ms, WheelFlush &out) {
+    if (!this->window_open_ || (int32_t) (now_ms - this->deadline_ms_) < 0)
+      return false;
+    if (this->pending_steps_ == 0) {
+      this->window_open_ = false;
+      return false;
+    }
+    this->deadline_ms_ = now_ms + this->window_ms_;
+    return this->take_(out);
+  }
+
+  // Sends whatever is pending now, e.g. before the run changes meaning.
+  bool flush(WheelFlush &out) {
+    if (this->pending_steps_ == 0)
+      return false;
+    return this->take_(out);
+  }
+
+  void reset() {
+    this->pending_steps_ = 0;
+    this->pending_q8_ = 0;
+    this->remainder_q8_ = 0;
+    this->window_open_ = false;
+    this->velocity_.reset();
+  }
+
+ protected:
+  bool take_(WheelFlush &out) {
+    const uint32_t total_q8 = this->pending_q8_ + this->remainder_q8_;
+    uint32_t delta = total_q8 / WHEEL_FACTOR_ONE;
+    if (delta > INT16_MAX)
+      delta = INT16_MAX;
+    this->remainder_q8_ = total_q8 % WHEEL_FACTOR_ONE;
+
+    out.direction = this->pending_direction_;
+    out.steps = this->pending_steps_;
+    out.delta = (int16_t) (this->pending_direction_ > 0 ? (int32_t) delta : -(int32_t) delta);
+    this->pending_steps_ = 0;
+    this->pending_q8_ = 0;
+    return true;
+  }
+
+  WheelVelocity velocity_;
+  WheelAcceleration acceleration_;
+  uint32_t window_ms_{0};
+  uint32_t deadline_ms_{0};
+  uint32_t pending_q8_{0};
+  uint32_t remainder_q8_{0};
+  uint32_t last_tick_us_{0};
+  bool window_open_{false};
+  int8_t pending_direction_{0};  // direction of the current run, kept after a flush
+  uint16_t pending_steps_{0};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
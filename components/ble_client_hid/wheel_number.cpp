@@ -0,0 +1,65 @@
+#include "wheel_number.h"
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+static const char *const TAG = "ble_client_hid.number";
+
+void WheelNumber::setup() {
+  this->value_ = this->clamp_(this->initial_value_);
+  this->publish_state(this->value_);
+  this->last_publish_ms_ = esphome::millis();
+}
+
+void WheelNumber::loop() {
+  if (!this->dirty_)
+    return;
+  const uint32_t now = esphome::millis();
+  if (now - this->last_publish_ms_ < this->publish_interval_ms_)
+    return;
+  this->dirty_ = false;
+  this->last_publish_ms_ = now;
+  this->publish_state(this->value_);
+}
+
+void WheelNumber::dump_config() {
+  LOG_NUMBER("", "BLE Client HID Wheel Number", this);
+  ESP_LOGCONFIG(TAG, "  Publish interval: %ums", (unsigned) this->publish_interval_ms_);
+  if (!this->seed_entity_id_.empty()) {
+    ESP_LOGCONFIG(TAG, "  Seed from: %s%s%s", this->seed_entity_id_.c_str(), this->seed_attribute_.empty() ? "" : " ",
+                  this->seed_attribute_.c_str());
+  }
+}
+
+void WheelNumber::apply_delta(int32_t delta) {
+  const float next = this->clamp_(this->value_ + (float) delta * this->traits.get_step());
+  if (next == this->value_)
+    return;
+  this->value_ = next;
+  this->dirty_ = true;
+}
+
+void WheelNumber::seed(float value) {
+  this->value_ = this->clamp_(value);
+  this->dirty_ = false;
+  this->last_publish_ms_ = esphome::millis();
+  this->publish_state(this->value_);
+}
+
+void WheelNumber::control(float value) { this->seed(value); }
+
+float WheelNumber::clamp_(float value) const {
+  const float lo = this->traits.get_min_value();
+  const float hi = this->traits.get_max_value();
+  if (value < lo)
+    return lo;
+  if (value > hi)
+    return hi;
+  return value;
+}
+
+}  // namespace ble_client_hid
+}  // namespace esphome
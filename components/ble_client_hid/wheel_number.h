@@ -0,0 +1,47 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/components/number/number.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+// Bounded value moved by the wheel on the device. Publishing is throttled:
+// the latest value wins, at most one publish per interval, and the final value
+// always goes out once the wheel stops.
+class WheelNumber : public number::Number, public Component {
+ public:
+  void setup() override;
+  void loop() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+  void set_initial_value(float initial_value) { this->initial_value_ = initial_value; }
+  void set_publish_interval(uint32_t publish_interval_ms) { this->publish_interval_ms_ = publish_interval_ms; }
+  void set_seed_entity(const std::string &entity_id, const std::string &attribute) {
+    this->seed_entity_id_ = entity_id;
+    this->seed_attribute_ = attribute;
+  }
+  const std::string &get_seed_entity_id() const { return this->seed_entity_id_; }
+  const std::string &get_seed_attribute() const { return this->seed_attribute_; }
+
+  // Moves the value by `delta` steps (already scaled by the acceleration curve).
+  void apply_delta(int32_t delta);
+  // Replaces the value without counting as wheel input, e.g. from Home Assistant on connect.
+  void seed(float value);
+
+ protected:
+  void control(float value) override;
+  float clamp_(float value) const;
+
+  float value_{0.0f};
+  float initial_value_{0.0f};
+  uint32_t publish_interval_ms_{200};
+  uint32_t last_publish_ms_{0};
+  bool dirty_{false};
+  std::string seed_entity_id_;
+  std::string seed_attribute_;
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
@@ -0,0 +1,233 @@
+// Host benchmarks of the ble_client_hid event path.
+//
+//   cmake -S host -B build/host && cmake --build build/host
+//   build/host/bench_hid
+//
+// `allocs` is heap allocations per iteration, counted by the operator new
+// below; the device pays for each one in heap fragmentation as well as time.
+
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "event_data.h"
+#include "event_pipeline.h"
+#include "gestures_essence.h"
+#include "hid_parser.h"
+#include "notify_pairs.h"
+#include "profile_essence.h"
+
+static std::atomic<uint64_t> g_allocs{0};
+
+// Kept out of line: GCC takes an inlined malloc()/free() pair around a call to
+// the other operator for a mismatched new and delete.
+__attribute__((noinline)) void *operator new(std::size_t size) {
+  g_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void *p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace esphome {
+namespace ble_client_hid {
+namespace {
+
+// Keyboard (report 1) and consumer control (report 2), as a typical BLE remote sends them.
+const uint8_t REPORT_MAP[] = {
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x85, 0x01, 0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25,
+    0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02, 0x95, 0x01, 0x75, 0x08, 0x81, 0x01, 0x95, 0x06, 0x75, 0x08,
+    0x15, 0x00, 0x25, 0x65, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00, 0xC0, 0x05, 0x0C, 0x09, 0x01, 0xA1, 0x01,
+    0x85, 0x02, 0x15, 0x00, 0x26, 0xFF, 0x03, 0x19, 0x00, 0x2A, 0xFF, 0x03, 0x75, 0x10, 0x95, 0x01, 0x81,
+    0x00, 0xC0,
+};
+
+// Essence reports: up pressed, released; wheel right.
+const uint8_t ESSENCE_UP[] = {0x00, 0x06};
+const uint8_t ESSENCE_RELEASE[] = {0x00, 0x00};
+const uint8_t ESSENCE_RIGHT[] = {0x40, 0x00};
+
+void set_allocs(benchmark::State &state, uint64_t start) {
+  state.counters["allocs"] =
+      benchmark::Counter((double) (g_allocs.load() - start), benchmark::Counter::kAvgIterations);
+}
+
+NotifyRecord record(const uint8_t *data, uint8_t len, uint32_t t_us) {
+  NotifyRecord rec;
+  rec.assign(0, data, len, t_us);
+  return rec;
+}
+
+void BM_ParseReportMap(benchmark::State &state) {
+  const uint64_t start = g_allocs.load();
+  for (auto _ : state) {
+    HIDReportMap *map = HIDReportMap::parse_report_map_data(REPORT_MAP, sizeof(REPORT_MAP));
+    benchmark::DoNotOptimize(map);
+    delete map;
+  }
+  set_allocs(state, start);
+}
+BENCHMARK(BM_ParseReportMap);
+
+// Generic descriptor-driven decoding of a consumer press and release.
+void BM_ParseReport(benchmark::State &state) {
+  HIDReportMap *map = HIDReportMap::parse_report_map_data(REPORT_MAP, sizeof(REPORT_MAP));
+  uint8_t press[] = {0x02, 0xE9, 0x00};
+  uint8_t release[] = {0x02, 0x00, 0x00};
+  const uint64_t start = g_allocs.load();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map->parse(press));
+    benchmark::DoNotOptimize(map->parse(release));
+  }
+  set_allocs(state, start);
+  delete map;
+}
+BENCHMARK(BM_ParseReport);
+
+// Profile decoding of an Essence press and release.
+void BM_DecodeReport(benchmark::State &state) {
+  ReportDecoder decoder;
+  decoder.set_profile(&PROFILE_ESSENCE);
+  ControlEdge edges[MAX_EDGES_PER_REPORT];
+  const uint64_t start = g_allocs.load();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(decoder.decode(PROFILE_ESSENCE.decode_key(ESSENCE_UP), edges));
+    benchmark::DoNotOptimize(decoder.decode(PROFILE_ESSENCE.decode_key(ESSENCE_RELEASE), edges));
+  }
+  set_allocs(state, start);
+}
+BENCHMARK(BM_DecodeReport);
+
+// Lookups the NOTIFY handler and the CCC bookkeeping do per notification or
+// write, with range(0) pairs known: the last pair, then a handle not known.
+void BM_NotifyPairLookup(benchmark::State &state) {
+  RemoteBleState ble;
+  const uint16_t pairs = (uint16_t) state.range(0);
+  for (uint16_t i = 0; i < pairs; i++) {
+    ble.add_pair(NotifyPair{(uint16_t) (30 + 4 * i), (uint16_t) (31 + 4 * i)});
+    ble.ccc_entry(31 + 4 * i);
+  }
+  const uint16_t last_input = 30 + 4 * (pairs - 1);
+  const uint64_t start = g_allocs.load();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ble.input_is_known(last_input));
+    benchmark::DoNotOptimize(ble.find_ccc(last_input + 1));
+    benchmark::DoNotOptimize(ble.input_is_known(2));
+    benchmark::DoNotOptimize(ble.find_ccc(3));
+  }
+  set_allocs(state, start);
+}
+BENCHMARK(BM_NotifyPairLookup)->Arg(2)->Arg(MAX_NOTIFY_PAIRS)->ArgName("pairs");
+
+// The same lookups through the file-static maps the component used before its
+// state moved into RemoteBleState: per-instance state keyed by component
+// pointer, three remotes configured, pairs in a vector, CCC state in a map.
+struct MapCccState {
+  bool enabled{false};
+  uint32_t last_attempt_ms{0};
+};
+struct MapInstanceState {
+  std::vector<NotifyPair> pairs;
+  std::map<uint16_t, MapCccState> ccc_by_ccc;
+};
+
+void BM_NotifyPairLookup_Map(benchmark::State &state) {
+  static const int INSTANCES[3] = {};
+  std::map<const void *, MapInstanceState> by_instance;
+  const uint16_t pairs = (uint16_t) state.range(0);
+  for (const int &instance : INSTANCES) {
+    auto &st = by_instance[&instance];
+    for (uint16_t i = 0; i < pairs; i++) {
+      st.pairs.push_back(NotifyPair{(uint16_t) (30 + 4 * i), (uint16_t) (31 + 4 * i)});
+      st.ccc_by_ccc[31 + 4 * i];
+    }
+  }
+  const void *self = &INSTANCES[1];
+  auto input_is_known = [&](uint16_t input_handle) {
+    auto &st = by_instance[self];
+    for (auto &p : st.pairs)
+      if (p.input_handle == input_handle)
+        return true;
+    return false;
+  };
+  auto find_ccc = [&](uint16_t ccc_handle) -> MapCccState * {
+    auto &st = by_instance[self];
+    auto it = st.ccc_by_ccc.find(ccc_handle);
+    return it == st.ccc_by_ccc.end() ? nullptr : &it->second;
+  };
+  const uint16_t last_input = 30 + 4 * (pairs - 1);
+  const uint64_t start = g_allocs.load();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(input_is_known(last_input));
+    benchmark::DoNotOptimize(find_ccc(last_input + 1));
+    benchmark::DoNotOptimize(input_is_known(2));
+    benchmark::DoNotOptimize(find_ccc(3));
+  }
+  set_allocs(state, start);
+}
+BENCHMARK(BM_NotifyPairLookup_Map)->Arg(2)->Arg(MAX_NOTIFY_PAIRS)->ArgName("pairs");
+
+// Sink as in BLEClientHID::emit_event: text always, the API data map when range(0) is set.
+GestureSink event_sink(bool with_map, uint64_t &events) {
+  static const std::string SOURCE = "bench";
+  return [with_map, &events](const RemoteEvent &event) {
+    const EventText text(event);
+    benchmark::DoNotOptimize(text.action);
+    if (with_map)
+      benchmark::DoNotOptimize(event_data(event, text, "00:11:22:33:44:55", SOURCE, nullptr));
+    events++;
+  };
+}
+
+// One up click per iteration, a second apart, so every click completes as up_single.
+void BM_NotifyToEvent_Click(benchmark::State &state) {
+  uint64_t events = 0;
+  EventPipeline pipeline;
+  pipeline.set_profile(&PROFILE_ESSENCE);
+  pipeline.set_gestures(&GESTURES_ESSENCE);
+  pipeline.set_sink(event_sink(state.range(0) != 0, events));
+  uint32_t t_us = 0;
+  const uint64_t start = g_allocs.load();
+  for (auto _ : state) {
+    pipeline.feed(record(ESSENCE_UP, sizeof(ESSENCE_UP), t_us));
+    pipeline.feed(record(ESSENCE_RELEASE, sizeof(ESSENCE_RELEASE), t_us + 80000));
+    t_us += 1000000;
+    pipeline.poll(t_us, t_us / 1000);
+  }
+  set_allocs(state, start);
+  state.counters["events"] = benchmark::Counter((double) events, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_NotifyToEvent_Click)->Arg(0)->Arg(1)->ArgName("map");
+
+// Wheel ticks 20 ms apart, coalesced over a 50 ms window (the default, 0, sends every batch).
+void BM_NotifyToEvent_Wheel(benchmark::State &state) {
+  uint64_t events = 0;
+  EventPipeline pipeline;
+  pipeline.set_profile(&PROFILE_ESSENCE);
+  pipeline.set_gestures(&GESTURES_ESSENCE);
+  pipeline.wheel().set_window_ms(50);
+  pipeline.set_sink(event_sink(state.range(0) != 0, events));
+  // Millis from a 64-bit clock, as millis() does; the micros stamps wrap on their own.
+  uint64_t t_us = 0;
+  const uint64_t start = g_allocs.load();
+  for (auto _ : state) {
+    pipeline.feed(record(ESSENCE_RIGHT, sizeof(ESSENCE_RIGHT), (uint32_t) t_us));
+    pipeline.feed(record(ESSENCE_RELEASE, sizeof(ESSENCE_RELEASE), (uint32_t) (t_us + 10000)));
+    t_us += 20000;
+    pipeline.poll((uint32_t) t_us, (uint32_t) (t_us / 1000));
+  }
+  set_allocs(state, start);
+  state.counters["events"] = benchmark::Counter((double) events, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_NotifyToEvent_Wheel)->Arg(0)->Arg(1)->ArgName("map");
+
+}  // namespace
+}  // namespace ble_client_hid
+}  // namespace esphome
+
+BENCHMARK_MAIN();
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "notify_pairs.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+// One HID report characteristic of the simulated remote.
+struct FakeReport {
+  uint16_t input_handle{0};
+  uint16_t ccc_handle{0};
+  bool indicate{false};  // indicate only, no notify property
+};
+
+// -----------------------------------------------------------------------------
+// What one wake of a remote looks like, in ms after ESP_GATTC_OPEN_EVT.
+// -----------------------------------------------------------------------------
+struct RemoteScript {
+  std::vector<FakeReport> reports;
+  uint16_t wake_handle{0};  // input handle of the report carrying the wake press
+
+  uint32_t search_ms{0};  // ESP_GATTC_SEARCH_CMPL_EVT
+  uint32_t auth_ms{0};    // ESP_GAP_BLE_AUTH_CMPL_EVT
+  uint32_t write_ms{0};   // a CCC write reaches the remote this much later
+  bool ccc_needs_auth{false};  // writes before encryption are rejected
+  bool auth_resets_ccc{false};  // the remote clears its CCCs when encryption completes
+  bool ccc_persisted{false};    // bonded: CCCs are still set from the last connection
+
+  uint32_t press_ms{0};  // the remote first tries to send the wake press
+  uint32_t hold_ms{0};   // and keeps it this long before dropping it
+  bool cache_warm{false};  // the component has the handle cache for this remote
+};
+
+// -----------------------------------------------------------------------------
+// Host stand-in for the esp_ble_gattc_* calls BLEClientHID makes on the way
+// to a subscription, connected to a scripted remote. Calls are named after
+// the ESP-IDF functions they replace and behave as seen from the component:
+// a CCC write is accepted (ESP_OK) while the link is up, and only reaches the
+// remote, which may reject it, write_ms later.
+// -----------------------------------------------------------------------------
+class FakeGattc {
+ public:
+  explicit FakeGattc(const RemoteScript &script) : script_(script) {
+    for (const FakeReport &r : script.reports)
+      this->cccs_.push_back(PeerCcc{r.ccc_handle, (uint16_t) (script.ccc_persisted ? CCC_NOTIFY | CCC_INDICATE : 0)});
+  }
+
+  // esp_ble_gattc_write_char_descr on a CCC.
+  bool write_char_descr(uint32_t now_ms, uint16_t ccc_handle, uint16_t value) {
+    this->writes_++;
+    this->pending_.push_back(PendingWrite{now_ms + this->script_.write_ms, ccc_handle, value});
+    return true;
+  }
+  // esp_ble_gattc_register_for_notify: local to the stack, immediate.
+  bool register_for_notify(uint16_t input_handle) {
+    this->registrations_++;
+    for (uint16_t h : this->registered_) {
+      if (h == input_handle)
+        return true;
+    }
+    this->registered_.push_back(input_handle);
+    return true;
+  }
+  // esp_ble_gattc_get_db as discover_notify_pairs() reads it: the pairs it finds.
+  void discover(RemoteBleState &state) const {
+    for (const FakeReport &r : this->script_.reports) {
+      state.add_pair(NotifyPair{r.input_handle, r.ccc_handle});
+      CccEntry *entry = state.ccc_entry(r.ccc_handle);
+      if (entry != nullptr)
+        entry->desired = r.indicate ? CCC_INDICATE : CCC_NOTIFY;
+    }
+  }
+
+  // Remote side up to `now_ms`: writes arriving, encryption completing.
+  void advance(uint32_t now_ms) {
+    if (!this->encrypted_ && now_ms >= this->script_.auth_ms) {
+      this->encrypted_ = true;
+      if (this->script_.auth_resets_ccc) {
+        for (PeerCcc &c : this->cccs_)
+          c.value = 0;
+      }
+    }
+    for (size_t i = 0; i < this->pending_.size();) {
+      const PendingWrite &w = this->pending_[i];
+      if (w.at_ms > now_ms) {
+        i++;
+        continue;
+      }
+      if (this->encrypted_ || !this->script_.ccc_needs_auth) {
+        for (PeerCcc &c : this->cccs_) {
+          if (c.handle == w.ccc_handle)
+            c.value = w.value;
+        }
+      } else {
+        this->rejected_++;
+      }
+      this->pending_.erase(this->pending_.begin() + i);
+    }
+  }
+
+  // A report on `input_handle` sent now would reach BLEClientHID's notify handler.
+  bool delivers(uint16_t input_handle) const {
+    bool registered = false;
+    for (uint16_t h : this->registered_)
+      registered |= h == input_handle;
+    if (!registered)
+      return false;
+    for (size_t i = 0; i < this->script_.reports.size(); i++) {
+      const FakeReport &r = this->script_.reports[i];
+      if (r.input_handle == input_handle)
+        return (this->cccs_[i].value & (r.indicate ? CCC_INDICATE : CCC_NOTIFY)) != 0;
+    }
+    return false;
+  }
+
+  uint32_t writes() const { return this->writes_; }
+  uint32_t rejected() const { return this->rejected_; }
+  uint32_t registrations() const { return this->registrations_; }
+
+ protected:
+  struct PeerCcc {
+    uint16_t handle;
+    uint16_t value;
+  };
+  struct PendingWrite {
+    uint32_t at_ms;
+    uint16_t ccc_handle;
+    uint16_t value;
+  };
+
+  const RemoteScript &script_;
+  std::vector<PeerCcc> cccs_;
+  std::vector<PendingWrite> pending_;
+  std::vector<uint16_t> registered_;
+  bool encrypted_{false};
+  uint32_t writes_{0};
+  uint32_t rejected_{0};
+  uint32_t registrations_{0};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome
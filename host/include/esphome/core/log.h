@@ -0,0 +1,69 @@
+#pragma once
+
+// Host stand-in for esphome/core/log.h, so the transport independent sources
+// build unchanged. Levels below ESPHOME_LOG_LEVEL compile out, arguments
+// included, as on the device.
+
+#include <cstdarg>
+#include <cstdio>
+
+#define ESPHOME_LOG_LEVEL_NONE 0
+#define ESPHOME_LOG_LEVEL_ERROR 1
+#define ESPHOME_LOG_LEVEL_WARN 2
+#define ESPHOME_LOG_LEVEL_INFO 3
+#define ESPHOME_LOG_LEVEL_CONFIG 4
+#define ESPHOME_LOG_LEVEL_DEBUG 5
+#define ESPHOME_LOG_LEVEL_VERBOSE 6
+#define ESPHOME_LOG_LEVEL_VERY_VERBOSE 7
+
+#ifndef ESPHOME_LOG_LEVEL
+#define ESPHOME_LOG_LEVEL ESPHOME_LOG_LEVEL_WARN
+#endif
+
+namespace esphome {
+
+inline void host_log(char level, const char *tag, const char *format, ...) {
+  std::fprintf(stderr, "[%c][%s] ", level, tag);
+  va_list args;
+  va_start(args, format);
+  std::vfprintf(stderr, format, args);
+  va_end(args);
+  std::fputc('\n', stderr);
+}
+
+}  // namespace esphome
+
+#define ESPHOME_HOST_LOG_OFF_() \
+  do { \
+  } while (0)
+
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_ERROR
+#define ESP_LOGE(tag, ...) ::esphome::host_log('E', tag, __VA_ARGS__)
+#else
+#define ESP_LOGE(tag, ...) ESPHOME_HOST_LOG_OFF_()
+#endif
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_WARN
+#define ESP_LOGW(tag, ...) ::esphome::host_log('W', tag, __VA_ARGS__)
+#else
+#define ESP_LOGW(tag, ...) ESPHOME_HOST_LOG_OFF_()
+#endif
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_INFO
+#define ESP_LOGI(tag, ...) ::esphome::host_log('I', tag, __VA_ARGS__)
+#else
+#define ESP_LOGI(tag, ...) ESPHOME_HOST_LOG_OFF_()
+#endif
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_CONFIG
+#define ESP_LOGCONFIG(tag, ...) ::esphome::host_log('C', tag, __VA_ARGS__)
+#else
+#define ESP_LOGCONFIG(tag, ...) ESPHOME_HOST_LOG_OFF_()
+#endif
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_DEBUG
+#define ESP_LOGD(tag, ...) ::esphome::host_log('D', tag, __VA_ARGS__)
+#else
+#define ESP_LOGD(tag, ...) ESPHOME_HOST_LOG_OFF_()
+#endif
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE
+#define ESP_LOGV(tag, ...) ::esphome::host_log('V', tag, __VA_ARGS__)
+#else
+#define ESP_LOGV(tag, ...) ESPHOME_HOST_LOG_OFF_()
+#endif
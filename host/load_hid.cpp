@@ -0,0 +1,473 @@
+// Synthetic load on the event path: N virtual remotes sharing one main loop,
+// the first ones spinning the wheel in step, the rest pressing buttons. Finds
+// where events start to lag on a single small core.
+//
+//   load_hid [options]
+//   load_hid --sweep wheel      raise the wheel rate until events lag
+//   load_hid --sweep remotes    add remotes until events lag
+//
+// Time is virtual. Each component's loop() costs the host CPU time of its
+// pipeline calls times --cpu-scale, each event the host time of building its
+// API data times --cpu-scale plus a modelled API send (--send-us, with a
+// --spike-pct share of sends taking --spike-us, as on a busy WiFi link).
+// Each notification preempts the loop on the Bluedroid task for --hook-us
+// (esp32_ble queueing the GATTC event). The GATTC event is dispatched on the
+// main loop: esp32_ble's loop() runs first in every iteration and hands each
+// queued event to the clients, --dispatch-us each, before any component
+// decodes. The record is stamped and queued at dispatch, or on arrival with
+// --hook (a BLE_HID_NOTIFY_HOOK build). Latency is notify to the end of the
+// send, for events a record produced; events from gesture deadlines are late
+// by the loop lag, reported separately.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "event_data.h"
+#include "event_pipeline.h"
+#include "gestures_essence.h"
+#include "profile_essence.h"
+
+using namespace esphome::ble_client_hid;
+
+namespace {
+
+// Essence reports: the four navigation keys, wheel right, release.
+const uint8_t ESSENCE_KEYS[][2] = {{0x00, 0x06}, {0x00, 0x0b}, {0x00, 0x0a}, {0x00, 0x01}};
+const uint8_t ESSENCE_RIGHT[] = {0x40, 0x00};
+const uint8_t ESSENCE_RELEASE[] = {0x00, 0x00};
+
+static constexpr uint32_t PRESS_HOLD_US = 80000;
+static constexpr uint32_t TAIL_US = 2000000;  // after the last arrival, for pending gestures
+static constexpr uint32_t SWEEP_MAX_WHEEL_HZ = 1000;
+static constexpr uint32_t SWEEP_MAX_REMOTES = 16;
+
+struct Config {
+  uint32_t remotes{3};
+  uint32_t wheel_remotes{3};
+  double wheel_hz{40};  // detents per second on each spinning remote
+  double press_hz{1};   // presses per second on each other remote
+  uint32_t duration_s{10};
+  uint32_t loop_ms{16};
+  double cpu_scale{25};  // device CPU time per host CPU time
+  uint32_t send_us{600};
+  uint32_t spike_us{20000};
+  double spike_pct{1};
+  uint32_t hook_us{15};
+  uint32_t dispatch_us{40};
+  bool hook{false};  // BLE_HID_NOTIFY_HOOK: records queued on the Bluedroid task
+  uint32_t overhead_us{300};  // other components, per loop() iteration
+  uint32_t wheel_window_ms{0};
+  uint32_t max_lag_ms{50};
+  uint32_t seed{1};
+  const char *sweep{nullptr};
+};
+
+struct Arrival {
+  uint64_t t_us;
+  uint8_t remote;
+  const uint8_t *data;
+};
+
+struct Result {
+  uint64_t notifications{0};
+  uint64_t events{0};
+  uint32_t overflows{0};
+  size_t max_depth{0};
+  uint64_t busy_us{0};
+  uint64_t elapsed_us{0};
+  std::vector<uint32_t> latency_us;   // record to end of send
+  std::vector<uint32_t> loop_lag_us;  // iteration start past its schedule
+  std::vector<uint32_t> dispatch_wait_us;  // GATTC event queued until dispatched
+};
+
+// Notifications of the whole run, by arrival time. The spinning remotes tick
+// in step, the worst case for one loop iteration.
+std::vector<Arrival> make_traffic(const Config &cfg, std::mt19937 &rng) {
+  std::vector<Arrival> out;
+  const uint64_t end_us = (uint64_t) cfg.duration_s * 1000000;
+  for (uint32_t r = 0; r < cfg.remotes; r++) {
+    if (r < cfg.wheel_remotes) {
+      if (cfg.wheel_hz <= 0)
+        continue;
+      const double period_us = 1e6 / cfg.wheel_hz;
+      for (double t = 0; t < end_us; t += period_us) {
+        out.push_back(Arrival{(uint64_t) t, (uint8_t) r, ESSENCE_RIGHT});
+        out.push_back(Arrival{(uint64_t) (t + period_us / 2), (uint8_t) r, ESSENCE_RELEASE});
+      }
+    } else if (cfg.press_hz > 0) {
+      std::exponential_distribution<double> gap(cfg.press_hz / 1e6);
+      std::uniform_int_distribution<int> key(0, 3);
+      for (uint64_t t = (uint64_t) gap(rng); t < end_us;
+           t += std::max<uint64_t>((uint64_t) gap(rng), 2 * PRESS_HOLD_US)) {
+        out.push_back(Arrival{t, (uint8_t) r, ESSENCE_KEYS[key(rng)]});
+        out.push_back(Arrival{t + PRESS_HOLD_US, (uint8_t) r, ESSENCE_RELEASE});
+      }
+    }
+  }
+  std::stable_sort(out.begin(), out.end(), [](const Arrival &a, const Arrival &b) { return a.t_us < b.t_us; });
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+// One device: a BLEClientHID per remote, all run by the same main loop, where
+// work takes virtual time.
+// -----------------------------------------------------------------------------
+class LoadDevice {
+ public:
+  LoadDevice(const Config &cfg, std::vector<Arrival> traffic)
+      : cfg_(cfg), traffic_(std::move(traffic)), rng_(cfg.seed) {
+    for (uint32_t i = 0; i < cfg.remotes; i++) {
+      this->slots_.emplace_back(new Slot());
+      Slot &slot = *this->slots_.back();
+      slot.pipeline.set_profile(&PROFILE_ESSENCE);
+      slot.pipeline.set_gestures(&GESTURES_ESSENCE);
+      slot.pipeline.wheel().set_window_ms(cfg.wheel_window_ms);
+      slot.pipeline.set_sink([&slot](const RemoteEvent &event) { slot.pending.push_back(event); });
+      slot.pending.reserve(64);
+    }
+    this->result_.latency_us.reserve(this->traffic_.size());
+    this->result_.dispatch_wait_us.reserve(this->traffic_.size());
+  }
+
+  Result run() {
+    const uint64_t end_us = (this->traffic_.empty() ? 0 : this->traffic_.back().t_us) + TAIL_US;
+    const uint64_t loop_us = (uint64_t) this->cfg_.loop_ms * 1000;
+    uint64_t scheduled = 0;
+    while (scheduled < end_us) {
+      // Idle until the iteration is due; the Bluedroid task has the core to itself.
+      if (this->now_ < scheduled)
+        this->now_ = scheduled;
+      this->deliver_(false);
+      this->result_.loop_lag_us.push_back((uint32_t) (this->now_ - scheduled));
+      const uint64_t start = this->now_;
+      this->dispatch_();
+      for (auto &slot : this->slots_)
+        this->loop_(*slot);
+      this->now_ += this->cfg_.overhead_us;
+      this->result_.busy_us += this->now_ - start;
+      // An iteration that overran starts the next one straight away, late.
+      scheduled = start + loop_us;
+    }
+    this->result_.elapsed_us = this->now_;
+    return std::move(this->result_);
+  }
+
+ protected:
+  struct Slot {
+    EventPipeline pipeline;
+    NotifyQueue queue;
+    std::deque<uint64_t> arrivals;  // arrival time of each queued record
+    std::vector<RemoteEvent> pending;
+  };
+
+  // The notifications that arrived by now, on the Bluedroid task. While the
+  // loop is busy that task preempts it for each one.
+  void deliver_(bool busy) {
+    while (this->next_ < this->traffic_.size() && this->traffic_[this->next_].t_us <= this->now_) {
+      const Arrival &a = this->traffic_[this->next_++];
+      this->result_.notifications++;
+      if (this->cfg_.hook)
+        this->queue_(a, a.t_us);
+      this->ble_events_.push_back(&a);
+      if (busy)
+        this->now_ += this->cfg_.hook_us;
+    }
+  }
+
+  // Stamps and queues a record, as gattc_event_handler() or notify_hook() do.
+  void queue_(const Arrival &a, uint64_t stamp_us) {
+    NotifyRecord rec;
+    rec.assign(0, a.data, 2, (uint32_t) stamp_us);
+    Slot &slot = *this->slots_[a.remote];
+    if (!slot.queue.push(rec)) {
+      this->result_.overflows++;
+      return;
+    }
+    slot.arrivals.push_back(a.t_us);
+    this->result_.max_depth = std::max(this->result_.max_depth, slot.queue.size());
+  }
+
+  // esp32_ble's loop(): drains its event queue, including events that arrive
+  // while it does, through every client's gattc_event_handler().
+  void dispatch_() {
+    for (size_t i = 0; i < this->ble_events_.size(); i++) {
+      const Arrival &a = *this->ble_events_[i];
+      this->result_.dispatch_wait_us.push_back((uint32_t) (this->now_ - a.t_us));
+      this->now_ += this->cfg_.dispatch_us;
+      if (!this->cfg_.hook)
+        this->queue_(a, this->now_);
+      this->deliver_(true);
+    }
+    this->ble_events_.clear();
+  }
+
+  void loop_(Slot &slot) {
+    NotifyRecord rec;
+    bool fed = false;
+    uint64_t first_arrival = 0;
+    for (uint8_t drained = 0; drained < NOTIFY_DRAIN_BATCH; drained++) {
+      this->deliver_(true);
+      if (!slot.queue.pop(rec))
+        break;
+      const uint64_t arrival = slot.arrivals.front();
+      slot.arrivals.pop_front();
+      if (!fed)
+        first_arrival = arrival;
+      fed = true;
+      this->charge_([&] { slot.pipeline.feed(rec); });
+      this->send_(slot, true, arrival);
+    }
+    this->charge_([&] { slot.pipeline.poll((uint32_t) this->now_, (uint32_t) (this->now_ / 1000)); });
+    // Wheel steps flush here; they belong to the batch that carried the ticks.
+    this->send_(slot, fed, first_arrival);
+  }
+
+  // Sends the pending events as BLEClientHID::emit_event does.
+  void send_(Slot &slot, bool from_record, uint64_t arrival_us) {
+    static const std::string SOURCE = "load";
+    std::uniform_real_distribution<double> pct(0, 100);
+    for (const RemoteEvent &event : slot.pending) {
+      this->charge_([&] {
+        const EventText text(event);
+        auto data = event_data(event, text, "00:11:22:33:44:55", SOURCE, nullptr);
+        this->sink_bytes_ += data.size();
+      });
+      this->now_ += pct(this->rng_) < this->cfg_.spike_pct ? this->cfg_.spike_us : this->cfg_.send_us;
+      this->result_.events++;
+      if (from_record)
+        this->result_.latency_us.push_back((uint32_t) (this->now_ - arrival_us));
+    }
+    slot.pending.clear();
+  }
+
+  // Runs `fn`, advancing the virtual clock by its scaled host CPU time.
+  template<typename F> void charge_(F &&fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    this->now_ += (uint64_t) (ns.count() * this->cfg_.cpu_scale / 1000.0);
+  }
+
+  const Config &cfg_;
+  std::vector<Arrival> traffic_;
+  std::vector<std::unique_ptr<Slot>> slots_;
+  std::mt19937 rng_;
+  Result result_;
+  std::vector<const Arrival *> ble_events_;  // GATTC events not yet dispatched
+  size_t next_{0};
+  uint64_t now_{0};
+  size_t sink_bytes_{0};
+};
+
+uint32_t percentile(std::vector<uint32_t> &values, unsigned pct) {
+  if (values.empty())
+    return 0;
+  const size_t index = (values.size() - 1) * pct / 100;
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+struct Summary {
+  double notify_per_s;
+  double events_per_s;
+  size_t max_depth;
+  uint32_t overflows;
+  uint32_t p50_us, p99_us, max_us;
+  uint32_t lag_p99_us, lag_max_us;
+  uint32_t dispatch_p99_us;
+  double busy_pct;
+  bool sustainable;
+};
+
+Summary run(const Config &cfg) {
+  std::mt19937 rng(cfg.seed);
+  LoadDevice device(cfg, make_traffic(cfg, rng));
+  Result r = device.run();
+  Summary s;
+  s.notify_per_s = r.notifications / (double) cfg.duration_s;
+  s.events_per_s = r.events / (double) cfg.duration_s;
+  s.max_depth = r.max_depth;
+  s.overflows = r.overflows;
+  s.p50_us = percentile(r.latency_us, 50);
+  s.p99_us = percentile(r.latency_us, 99);
+  s.max_us = percentile(r.latency_us, 100);
+  s.lag_p99_us = percentile(r.loop_lag_us, 99);
+  s.lag_max_us = percentile(r.loop_lag_us, 100);
+  s.dispatch_p99_us = percentile(r.dispatch_wait_us, 99);
+  s.busy_pct = r.elapsed_us > 0 ? 100.0 * r.busy_us / r.elapsed_us : 0;
+  s.sustainable = s.overflows == 0 && s.p99_us <= cfg.max_lag_ms * 1000;
+  return s;
+}
+
+void print_header() {
+  std::printf("%7s %8s %9s %9s %6s %6s %9s %9s %9s %9s %9s %6s\n", "remotes", "wheel_hz", "notify/s", "events/s",
+              "depth", "drops", "lat_p50", "lat_p99", "lat_max", "lag_p99", "disp_p99", "busy");
+}
+
+void print_row(const Config &cfg, const Summary &s) {
+  std::printf("%7u %8.1f %9.0f %9.0f %6zu %6u %7.1fms %7.1fms %7.1fms %7.1fms %7.1fms %5.0f%%%s\n", cfg.remotes,
+              cfg.wheel_hz, s.notify_per_s, s.events_per_s, s.max_depth, s.overflows, s.p50_us / 1000.0,
+              s.p99_us / 1000.0, s.max_us / 1000.0, s.lag_p99_us / 1000.0, s.dispatch_p99_us / 1000.0, s.busy_pct,
+              s.sustainable ? "" : "  lags");
+}
+
+bool parse_u32(const char *arg, uint32_t &out) {
+  char *end;
+  const unsigned long v = std::strtoul(arg, &end, 10);
+  if (end == arg || *end != '\0')
+    return false;
+  out = (uint32_t) v;
+  return true;
+}
+
+bool parse_double(const char *arg, double &out) {
+  char *end;
+  out = std::strtod(arg, &end);
+  return end != arg && *end == '\0' && out >= 0;
+}
+
+bool parse_options(int argc, char **argv, Config &cfg) {
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 >= argc)
+      return false;
+    const char *arg = argv[i];
+    const char *value = argv[++i];
+    bool ok;
+    if (std::strcmp(arg, "--remotes") == 0) {
+      ok = parse_u32(value, cfg.remotes) && cfg.remotes > 0 && cfg.remotes <= 255;
+    } else if (std::strcmp(arg, "--wheel-remotes") == 0) {
+      ok = parse_u32(value, cfg.wheel_remotes);
+    } else if (std::strcmp(arg, "--wheel-hz") == 0) {
+      ok = parse_double(value, cfg.wheel_hz);
+    } else if (std::strcmp(arg, "--press-hz") == 0) {
+      ok = parse_double(value, cfg.press_hz);
+    } else if (std::strcmp(arg, "--duration") == 0) {
+      ok = parse_u32(value, cfg.duration_s) && cfg.duration_s > 0 && cfg.duration_s <= 3600;
+    } else if (std::strcmp(arg, "--loop") == 0) {
+      ok = parse_u32(value, cfg.loop_ms) && cfg.loop_ms > 0;
+    } else if (std::strcmp(arg, "--cpu-scale") == 0) {
+      ok = parse_double(value, cfg.cpu_scale);
+    } else if (std::strcmp(arg, "--send-us") == 0) {
+      ok = parse_u32(value, cfg.send_us);
+    } else if (std::strcmp(arg, "--spike") == 0) {
+      const std::string v = value;
+      const size_t colon = v.find(':');
+      ok = colon != std::string::npos && parse_u32(v.substr(0, colon).c_str(), cfg.spike_us) &&
+           parse_double(v.substr(colon + 1).c_str(), cfg.spike_pct);
+    } else if (std::strcmp(arg, "--hook-us") == 0) {
+      ok = parse_u32(value, cfg.hook_us);
+    } else if (std::strcmp(arg, "--dispatch-us") == 0) {
+      ok = parse_u32(value, cfg.dispatch_us);
+    } else if (std::strcmp(arg, "--hook") == 0) {
+      uint32_t on;
+      ok = parse_u32(value, on) && on <= 1;
+      cfg.hook = on == 1;
+    } else if (std::strcmp(arg, "--overhead-us") == 0) {
+      ok = parse_u32(value, cfg.overhead_us);
+    } else if (std::strcmp(arg, "--wheel-window") == 0) {
+      ok = parse_u32(value, cfg.wheel_window_ms);
+    } else if (std::strcmp(arg, "--max-lag") == 0) {
+      ok = parse_u32(value, cfg.max_lag_ms);
+    } else if (std::strcmp(arg, "--seed") == 0) {
+      ok = parse_u32(value, cfg.seed);
+    } else if (std::strcmp(arg, "--sweep") == 0) {
+      cfg.sweep = value;
+      ok = std::strcmp(value, "wheel") == 0 || std::strcmp(value, "remotes") == 0;
+    } else {
+      ok = false;
+    }
+    if (!ok)
+      return false;
+  }
+  return true;
+}
+
+void usage() {
+  std::fprintf(stderr,
+               "usage: load_hid [options]\n"
+               "  --remotes N          virtual remotes (default 3)\n"
+               "  --wheel-remotes N    of which spin the wheel, in step (default 3)\n"
+               "  --wheel-hz HZ        wheel detents per second per spinning remote (default 40)\n"
+               "  --press-hz HZ        button presses per second per other remote (default 1)\n"
+               "  --duration S         seconds of traffic (default 10)\n"
+               "  --loop MS            main loop period (default 16)\n"
+               "  --cpu-scale X        device CPU time per host CPU time (default 25)\n"
+               "  --send-us US         API send time per event (default 600)\n"
+               "  --spike US:PCT       PCT%% of sends take US instead (default 20000:1)\n"
+               "  --hook-us US         Bluedroid task time per notification (default 15)\n"
+               "  --dispatch-us US     loop time to dispatch one GATTC event (default 40)\n"
+               "  --hook 0|1           queue records on arrival, as BLE_HID_NOTIFY_HOOK does (default 0)\n"
+               "  --overhead-us US     other components per loop iteration (default 300)\n"
+               "  --wheel-window MS    wheel coalesce window (default 0)\n"
+               "  --max-lag MS         p99 notify-to-send that still counts as keeping up (default 50)\n"
+               "  --seed S             button traffic and send spikes (default 1)\n"
+               "  --sweep wheel|remotes  raise the wheel rate or the remote count until events lag\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Config cfg;
+  if (!parse_options(argc, argv, cfg)) {
+    usage();
+    return 2;
+  }
+  cfg.wheel_remotes = std::min(cfg.wheel_remotes, cfg.remotes);
+  std::printf(
+      "loop %u ms, cpu x%.0f, send %u us (%.1f%% at %u us), hook %u us, dispatch %u us, queued at %s, "
+      "wheel window %u ms, max lag %u ms\n\n",
+      cfg.loop_ms, cfg.cpu_scale, cfg.send_us, cfg.spike_pct, cfg.spike_us, cfg.hook_us, cfg.dispatch_us,
+      cfg.hook ? "arrival" : "dispatch", cfg.wheel_window_ms, cfg.max_lag_ms);
+  print_header();
+
+  if (cfg.sweep == nullptr) {
+    print_row(cfg, run(cfg));
+    return 0;
+  }
+
+  const bool wheel = std::strcmp(cfg.sweep, "wheel") == 0;
+  const uint32_t wheel_remotes = cfg.wheel_remotes;
+  Config best{};
+  Summary best_summary{};
+  bool any = false;
+  bool limit = false;
+  if (!wheel)
+    cfg.remotes = 1;
+  for (;;) {
+    if (!wheel)
+      cfg.wheel_remotes = std::min(wheel_remotes, cfg.remotes);
+    const Summary s = run(cfg);
+    print_row(cfg, s);
+    if (!s.sustainable)
+      break;
+    best = cfg;
+    best_summary = s;
+    any = true;
+    if (wheel) {
+      cfg.wheel_hz = cfg.wheel_hz > 0 ? cfg.wheel_hz * 1.25 : 10;
+      limit = cfg.wheel_hz > SWEEP_MAX_WHEEL_HZ;
+    } else {
+      limit = ++cfg.remotes > SWEEP_MAX_REMOTES;
+    }
+    if (limit)
+      break;
+  }
+  if (!any) {
+    std::printf("\nnot sustainable at the starting point\n");
+    return 0;
+  }
+  if (limit)
+    std::printf("\nsweep limit reached without lag\n");
+  std::printf("\nmax sustainable: %u remote(s), %u spinning at %.1f Hz: %.0f events/s, %.0f notify/s\n",
+              best.remotes, best.wheel_remotes, best.wheel_hz, best_summary.events_per_s,
+              best_summary.notify_per_s);
+  return 0;
+}
@@ -0,0 +1,289 @@
+// Replays a notification capture through the event path on a virtual clock.
+//
+//   replay_hid [options] CAPTURE
+//
+// CAPTURE is a capture file, or a device log holding the output of the
+// <id>_dump_capture service ("capture: <hex>" lines; the last dump is used).
+// The event stream goes to stdout, one line per event; a summary to stderr.
+// With --no-timing the output carries no host CPU times and is the same on
+// every run, so a replay can be diffed against a stored one.
+//
+// The capture names the profile and gesture table it was decoded with. Only
+// the built-in ones are compiled in here; a capture of a custom profile or
+// custom gestures is refused rather than replayed through the wrong tables.
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "capture.h"
+#include "event_data.h"
+#include "gestures_essence.h"
+#include "profile_essence.h"
+#include "virtual_device.h"
+
+using namespace esphome::ble_client_hid;
+
+namespace {
+
+struct Options {
+  uint32_t loop_ms{16};
+  uint32_t stall_ms{0};
+  uint32_t stall_every_ms{0};
+  uint32_t multi_press_gap_ms{0};
+  uint32_t long_press_ms{0};
+  uint32_t wheel_window_ms{0};
+  uint32_t tail_ms{5000};
+  bool timing{true};
+  const char *path{nullptr};
+};
+
+void usage() {
+  std::fprintf(stderr,
+               "usage: replay_hid [options] CAPTURE\n"
+               "  --loop MS              main loop period (default 16)\n"
+               "  --stall MS:EVERY_MS    run one loop iteration MS late every EVERY_MS\n"
+               "  --multi-press-gap MS   override the multi-press gap of every button\n"
+               "  --long-press MS        override the long press time of every button\n"
+               "  --wheel-window MS      wheel coalesce window (default 0)\n"
+               "  --tail MS              keep running after the last record (default 5000)\n"
+               "  --no-timing            leave out host CPU times\n");
+}
+
+bool parse_ms(const char *arg, uint32_t &out) {
+  char *end;
+  const unsigned long v = std::strtoul(arg, &end, 10);
+  if (end == arg || *end != '\0')
+    return false;
+  out = (uint32_t) v;
+  return true;
+}
+
+bool parse_options(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (std::strcmp(arg, "--no-timing") == 0) {
+      opt.timing = false;
+      continue;
+    }
+    if (arg[0] != '-') {
+      opt.path = arg;
+      continue;
+    }
+    if (value == nullptr)
+      return false;
+    i++;
+    bool ok;
+    if (std::strcmp(arg, "--loop") == 0) {
+      ok = parse_ms(value, opt.loop_ms);
+    } else if (std::strcmp(arg, "--stall") == 0) {
+      const std::string v = value;
+      const size_t colon = v.find(':');
+      ok = colon != std::string::npos && parse_ms(v.substr(0, colon).c_str(), opt.stall_ms) &&
+           parse_ms(v.substr(colon + 1).c_str(), opt.stall_every_ms) && opt.stall_every_ms > 0;
+    } else if (std::strcmp(arg, "--multi-press-gap") == 0) {
+      ok = parse_ms(value, opt.multi_press_gap_ms);
+    } else if (std::strcmp(arg, "--long-press") == 0) {
+      ok = parse_ms(value, opt.long_press_ms);
+    } else if (std::strcmp(arg, "--wheel-window") == 0) {
+      ok = parse_ms(value, opt.wheel_window_ms);
+    } else if (std::strcmp(arg, "--tail") == 0) {
+      ok = parse_ms(value, opt.tail_ms);
+    } else {
+      ok = false;
+    }
+    if (!ok)
+      return false;
+  }
+  return opt.path != nullptr;
+}
+
+int hex_value(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+// The capture bytes of a binary file, or of the last dump in a device log.
+std::vector<uint8_t> load_capture(const char *path) {
+  std::ifstream file(path, std::ios::binary);
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (bytes.size() >= 4 && std::memcmp(bytes.data(), "HIDC", 4) == 0)
+    return bytes;
+
+  std::vector<uint8_t> capture;
+  std::istringstream log(std::string(bytes.begin(), bytes.end()));
+  std::string line;
+  while (std::getline(log, line)) {
+    if (line.find("Capture of ") != std::string::npos) {
+      capture.clear();
+      continue;
+    }
+    size_t pos = line.find("capture: ");
+    if (pos == std::string::npos)
+      continue;
+    for (pos += 9; pos + 1 < line.size(); pos += 2) {
+      const int hi = hex_value(line[pos]);
+      const int lo = hex_value(line[pos + 1]);
+      if (hi < 0 || lo < 0)
+        break;
+      capture.push_back((uint8_t) ((hi << 4) | lo));
+    }
+  }
+  return capture;
+}
+
+std::string mac_str(uint64_t mac) {
+  char buf[18];
+  std::snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X", (unsigned) (mac >> 40) & 0xFF,
+                (unsigned) (mac >> 32) & 0xFF, (unsigned) (mac >> 24) & 0xFF, (unsigned) (mac >> 16) & 0xFF,
+                (unsigned) (mac >> 8) & 0xFF, (unsigned) mac & 0xFF);
+  return buf;
+}
+
+// Profiles a capture can be replayed with, and their built-in gestures.
+struct ReplayProfile {
+  const RemoteProfile *profile;
+  const GestureTable *gestures;
+};
+const ReplayProfile REPLAY_PROFILES[] = {{&PROFILE_ESSENCE, &GESTURES_ESSENCE}};
+
+const ReplayProfile *find_profile(const char *name) {
+  for (const ReplayProfile &p : REPLAY_PROFILES) {
+    if (std::strcmp(p.profile->name, name) == 0)
+      return &p;
+  }
+  return nullptr;
+}
+
+uint32_t percentile(std::vector<uint32_t> &values, unsigned pct) {
+  if (values.empty())
+    return 0;
+  const size_t index = (values.size() - 1) * pct / 100;
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_options(argc, argv, opt)) {
+    usage();
+    return 2;
+  }
+  const std::vector<uint8_t> bytes = load_capture(opt.path);
+  CaptureReader reader;
+  if (!reader.open(bytes.data(), bytes.size())) {
+    std::fprintf(stderr, "%s: not a capture (version %u)\n", opt.path, (unsigned) CAPTURE_VERSION);
+    return 1;
+  }
+  const ReplayProfile *replay = find_profile(reader.profile());
+  if (replay == nullptr) {
+    std::fprintf(stderr, "%s: captured with profile '%s', which replay_hid does not have\n", opt.path,
+                 reader.profile());
+    return 1;
+  }
+  if (reader.gesture_states() != replay->gestures->state_count) {
+    std::fprintf(stderr, "%s: captured with custom gestures (%u states), replay_hid has the built-in ones of '%s'\n",
+                 opt.path, (unsigned) reader.gesture_states(), replay->profile->name);
+    return 1;
+  }
+  std::vector<CaptureRecord> records;
+  CaptureRecord rec;
+  while (reader.next(rec))
+    records.push_back(rec);
+  if (records.empty()) {
+    std::fprintf(stderr, "%s: capture holds no records\n", opt.path);
+    return 1;
+  }
+
+  VirtualDevice device;
+  EventPipeline &pipeline = device.pipeline();
+  pipeline.set_profile(replay->profile);
+  pipeline.set_gestures(replay->gestures);
+  for (uint8_t i = 0; i < MAX_BUTTONS; i++) {
+    ButtonConfig &cfg = pipeline.gestures().config((ButtonId) i);
+    if (opt.multi_press_gap_ms > 0)
+      cfg.multi_press_gap_ms = opt.multi_press_gap_ms;
+    if (opt.long_press_ms > 0)
+      cfg.long_press_ms = opt.long_press_ms;
+  }
+  pipeline.wheel().set_window_ms(opt.wheel_window_ms);
+  device.set_base_us(records.front().t_us);
+  device.set_loop_us(opt.loop_ms * 1000);
+  device.set_stall(opt.stall_ms * 1000, opt.stall_every_ms * 1000);
+
+  std::vector<uint32_t> latencies_us;
+  std::vector<uint32_t> cpu_ns;
+  uint32_t events = 0;
+  device.set_sink([&](const EmittedEvent &e) {
+    const EventText text(e.event);
+    std::printf("%10.3f %s raw=%s clicks=%s", e.emit_us / 1000.0, text.action, text.raw, text.clicks);
+    if (e.event.steps > 0)
+      std::printf(" steps=%u delta=%d", (unsigned) e.event.steps, (int) e.event.delta);
+    if (e.event.repeat > 0)
+      std::printf(" repeat=%u", (unsigned) e.event.repeat);
+    if (e.event.gesture > 0)
+      std::printf(" gesture=%u%s", (unsigned) e.event.gesture, e.event.provisional ? " provisional" : "");
+    if (e.from_record) {
+      const uint32_t latency_us = (uint32_t) (e.emit_us - e.arrival_us);
+      latencies_us.push_back(latency_us);
+      std::printf(" latency=%.3f", latency_us / 1000.0);
+    }
+    if (opt.timing)
+      std::printf(" cpu=%uns", (unsigned) e.cpu_ns);
+    std::printf("\n");
+    cpu_ns.push_back(e.cpu_ns);
+    events++;
+  });
+
+  const auto wall_start = std::chrono::steady_clock::now();
+  uint64_t at_us = 0;
+  uint32_t prev_t_us = records.front().t_us;
+  int remote = -1;
+  for (const CaptureRecord &r : records) {
+    at_us += (uint32_t) (r.t_us - prev_t_us);
+    prev_t_us = r.t_us;
+    if (r.remote != remote) {
+      // Another remote took the slot: the component starts over, as in retarget_remote().
+      device.run_until(at_us);
+      if (remote >= 0)
+        pipeline.reset();
+      remote = r.remote;
+      std::printf("%10.3f # remote %s\n", at_us / 1000.0,
+                  remote < reader.remote_count() ? mac_str(reader.remote(remote)).c_str() : "other");
+    }
+    device.arrive(at_us, r.handle, r.data, r.len);
+  }
+  device.run_until(at_us + (uint64_t) opt.tail_ms * 1000);
+  const double wall_ms =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall_start).count();
+
+  std::fprintf(stderr, "records %zu, events %u, loop() runs %" PRIu64 ", stalls %u\n", records.size(), events,
+               device.loops(), device.stalls());
+  std::fprintf(stderr, "queue: max depth %zu of %zu, overflows %u\n", device.max_depth(), NotifyQueue::capacity(),
+               device.overflows());
+  std::fprintf(stderr, "notify to event (virtual): p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+               percentile(latencies_us, 50) / 1000.0, percentile(latencies_us, 99) / 1000.0,
+               percentile(latencies_us, 100) / 1000.0);
+  if (opt.timing) {
+    std::fprintf(stderr, "cpu per event: p50 %u ns, p99 %u ns, max %u ns\n", percentile(cpu_ns, 50),
+                 percentile(cpu_ns, 99), percentile(cpu_ns, 100));
+    std::fprintf(stderr, "replayed %.1f s of capture in %.1f ms\n", at_us / 1e6, wall_ms);
+  }
+  return 0;
+}
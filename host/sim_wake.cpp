@@ -0,0 +1,259 @@
+// Simulates the first press after a wake against randomised remotes and
+// compares subscription strategies.
+//
+//   sim_wake [--scenarios N] [--seed S] [--loop MS] [--cold]
+//
+// Every strategy runs the same scenarios. A scenario is one wake: the remote
+// connects, sends the press that woke it and holds it for a while; the press
+// is captured if the remote has the CCC bit set and the handle is registered
+// before it gives up. Timing and remote behaviour are drawn per scenario, see
+// random_script().
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "fake_gattc.h"
+#include "subscription.h"
+
+using namespace esphome::ble_client_hid;
+
+namespace {
+
+static constexpr uint16_t FALLBACK_INPUT_HANDLE = 62;
+static constexpr uint16_t FALLBACK_CCC_HANDLE = 63;
+static constexpr uint32_t HORIZON_MS = 10000;
+
+struct Options {
+  uint32_t scenarios{10000};
+  uint32_t seed{1};
+  uint32_t loop_ms{16};
+  bool cold{false};
+};
+
+struct Preset {
+  const char *name;
+  SubscribeStrategy strategy;
+};
+
+SubscribeStrategy make_strategy(std::initializer_list<uint32_t> steps, bool search, bool auth,
+                                uint32_t min_interval_ms) {
+  SubscribeStrategy s;
+  s.open_step_count = 0;
+  for (uint32_t ms : steps)
+    s.open_steps_ms[s.open_step_count++] = ms;
+  s.on_search_complete = search;
+  s.on_auth_complete = auth;
+  s.min_interval_ms = min_interval_ms;
+  return s;
+}
+
+std::vector<Preset> presets() {
+  return {
+      {"default", SubscribeStrategy{}},
+      {"immediate", make_strategy({0, 80, 600, 2000}, true, true, 5000)},
+      {"no_guard", make_strategy({80, 600, 2000}, true, true, 0)},
+      {"immediate_no_guard", make_strategy({0, 80, 300, 600, 1200, 2000}, true, true, 0)},
+      {"search_auth_only", make_strategy({}, true, true, 5000)},
+      {"open_only", make_strategy({80, 600, 2000}, false, false, 5000)},
+  };
+}
+
+uint32_t uniform(std::mt19937 &rng, uint32_t lo, uint32_t hi) {
+  return std::uniform_int_distribution<uint32_t>(lo, hi)(rng);
+}
+bool chance(std::mt19937 &rng, unsigned pct) { return uniform(rng, 0, 99) < pct; }
+
+// One wake. The ranges are guesses from logs of a few remotes, not measurements;
+// they are here to be argued with.
+RemoteScript random_script(std::mt19937 &rng, bool force_cold) {
+  RemoteScript s;
+  if (chance(rng, 60)) {
+    // Essence layout: the press comes on the fallback pair.
+    s.reports = {{FALLBACK_INPUT_HANDLE, FALLBACK_CCC_HANDLE, false}, {66, 67, false}};
+    s.wake_handle = FALLBACK_INPUT_HANDLE;
+  } else {
+    s.reports = {{30, 31, false}, {34, 35, false}, {38, 39, false}};
+    s.wake_handle = chance(rng, 80) ? 30 : 34;
+  }
+  s.cache_warm = !force_cold && chance(rng, 85);
+  // Discovery is quick from the Bluedroid GATT cache, slow on a full service search.
+  s.search_ms = chance(rng, 70) ? uniform(rng, 40, 250) : uniform(rng, 300, 1500);
+  s.auth_ms = uniform(rng, 60, 1500);
+  s.write_ms = uniform(rng, 8, 90);  // one or two connection events
+  s.ccc_needs_auth = chance(rng, 40);
+  s.auth_resets_ccc = chance(rng, 25);
+  s.ccc_persisted = chance(rng, 50);
+  s.press_ms = uniform(rng, 0, 150);
+  // Half the remotes send once and forget, the rest retry for a while.
+  s.hold_ms = chance(rng, 50) ? uniform(rng, 0, 30) : uniform(rng, 200, 1500);
+  return s;
+}
+
+struct Outcome {
+  bool captured{false};
+  bool subscribed{false};
+  uint32_t subscribed_ms{0};
+  uint32_t writes{0};
+  uint32_t rejected{0};
+  uint32_t registrations{0};
+};
+
+// Runs one wake at 1 ms resolution; the component's loop() runs every loop_ms.
+Outcome run(const RemoteScript &script, const SubscribeStrategy &strategy, uint32_t loop_ms) {
+  RemoteBleState state;
+  FakeGattc gattc(script);
+  NotifySubscriber sub;
+  uint32_t now = 0;
+  sub.set_state(&state);
+  sub.set_strategy(strategy);
+  sub.set_write_ccc_function([&](uint16_t ccc, uint16_t value, const char *) {
+    return gattc.write_char_descr(now, ccc, value);
+  });
+  sub.set_register_function([&](uint16_t input, const char *) { return gattc.register_for_notify(input); });
+
+  // load_cached_pairs() at OPEN: the cache if there is one, then the fallback pair.
+  if (script.cache_warm) {
+    for (const FakeReport &r : script.reports) {
+      state.add_pair(NotifyPair{r.input_handle, r.ccc_handle});
+      state.ccc_entry(r.ccc_handle);
+    }
+  }
+  state.add_pair(NotifyPair{FALLBACK_INPUT_HANDLE, FALLBACK_CCC_HANDLE});
+  state.ccc_entry(FALLBACK_CCC_HANDLE);
+
+  Outcome out;
+  bool press_done = false;
+  sub.on_open(now);
+  for (; now < HORIZON_MS; now++) {
+    gattc.advance(now);
+    if (now == script.search_ms) {
+      gattc.discover(state);
+      sub.on_search_complete(now);
+    }
+    if (now == script.auth_ms)
+      sub.on_auth_complete(now);
+    if (now % loop_ms == 0)
+      sub.loop(now);
+    gattc.advance(now);
+
+    const bool delivers = gattc.delivers(script.wake_handle);
+    if (delivers && !out.subscribed) {
+      out.subscribed = true;
+      out.subscribed_ms = now;
+    }
+    if (!press_done && now >= script.press_ms) {
+      if (delivers) {
+        out.captured = true;
+        sub.on_notify(now);
+        press_done = true;
+      } else if (now >= script.press_ms + script.hold_ms) {
+        press_done = true;
+      }
+    }
+    if (press_done && out.subscribed && now > std::max(script.search_ms, script.auth_ms))
+      break;
+  }
+  out.writes = gattc.writes();
+  out.rejected = gattc.rejected();
+  out.registrations = gattc.registrations();
+  return out;
+}
+
+uint32_t percentile(std::vector<uint32_t> &values, unsigned pct) {
+  if (values.empty())
+    return 0;
+  const size_t index = (values.size() - 1) * pct / 100;
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+bool parse_u32(const char *arg, uint32_t &out) {
+  char *end;
+  const unsigned long v = std::strtoul(arg, &end, 10);
+  if (end == arg || *end != '\0')
+    return false;
+  out = (uint32_t) v;
+  return true;
+}
+
+bool parse_options(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    if (std::strcmp(arg, "--cold") == 0) {
+      opt.cold = true;
+      continue;
+    }
+    if (i + 1 >= argc)
+      return false;
+    const char *value = argv[++i];
+    bool ok;
+    if (std::strcmp(arg, "--scenarios") == 0) {
+      ok = parse_u32(value, opt.scenarios) && opt.scenarios > 0;
+    } else if (std::strcmp(arg, "--seed") == 0) {
+      ok = parse_u32(value, opt.seed);
+    } else if (std::strcmp(arg, "--loop") == 0) {
+      ok = parse_u32(value, opt.loop_ms) && opt.loop_ms > 0;
+    } else {
+      ok = false;
+    }
+    if (!ok)
+      return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!parse_options(argc, argv, opt)) {
+    std::fprintf(stderr,
+                 "usage: sim_wake [options]\n"
+                 "  --scenarios N   wakes per strategy (default 10000)\n"
+                 "  --seed S        scenario seed (default 1)\n"
+                 "  --loop MS       main loop period (default 16)\n"
+                 "  --cold          no remote has a handle cache\n");
+    return 2;
+  }
+
+  std::vector<RemoteScript> scripts;
+  scripts.reserve(opt.scenarios);
+  std::mt19937 rng(opt.seed);
+  for (uint32_t i = 0; i < opt.scenarios; i++)
+    scripts.push_back(random_script(rng, opt.cold));
+
+  std::printf("%u wakes, seed %u, loop %u ms%s\n\n", opt.scenarios, opt.seed, opt.loop_ms, opt.cold ? ", cold" : "");
+  std::printf("%-20s %9s %11s %8s %8s %8s %7s %7s %7s\n", "strategy", "captured", "never_subsc", "sub_p50",
+              "sub_p95", "sub_max", "writes", "reject", "regs");
+  for (const Preset &preset : presets()) {
+    uint32_t captured = 0;
+    uint32_t never = 0;
+    uint64_t writes = 0;
+    uint64_t rejected = 0;
+    uint64_t registrations = 0;
+    std::vector<uint32_t> subscribe_ms;
+    subscribe_ms.reserve(scripts.size());
+    for (const RemoteScript &script : scripts) {
+      const Outcome o = run(script, preset.strategy, opt.loop_ms);
+      captured += o.captured;
+      if (o.subscribed) {
+        subscribe_ms.push_back(o.subscribed_ms);
+      } else {
+        never++;
+      }
+      writes += o.writes;
+      rejected += o.rejected;
+      registrations += o.registrations;
+    }
+    const double n = scripts.size();
+    std::printf("%-20s %8.1f%% %10.1f%% %6u ms %6u ms %6u ms %7.2f %7.2f %7.2f\n", preset.name,
+                100.0 * captured / n, 100.0 * never / n, percentile(subscribe_ms, 50), percentile(subscribe_ms, 95),
+                percentile(subscribe_ms, 100), writes / n, rejected / n, registrations / n);
+  }
+  return 0;
+}
@@ -0,0 +1,730 @@
+// Unit tests of the transport independent core.
+//
+//   cmake -S host -B build/host && cmake --build build/host
+//   ctest --test-dir build/host
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "capture.h"
+#include "conn_params.h"
+#include "connection_scheduler.h"
+#include "event_data.h"
+#include "event_pipeline.h"
+#include "gestures_essence.h"
+#include "hid_parser.h"
+#include "profile_essence.h"
+#include "wheel.h"
+
+// Heap allocations of the whole binary, for tests of the allocation-free paths.
+static std::atomic<uint64_t> g_allocs{0};
+
+// Kept out of line: GCC takes an inlined malloc()/free() pair around a call to
+// the other operator for a mismatched new and delete.
+__attribute__((noinline)) void *operator new(std::size_t size) {
+  g_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void *p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace esphome {
+namespace ble_client_hid {
+namespace {
+
+// Keyboard (report 1) and consumer control (report 2), as in bench_hid.
+const uint8_t REPORT_MAP[] = {
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x85, 0x01, 0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25,
+    0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02, 0x95, 0x01, 0x75, 0x08, 0x81, 0x01, 0x95, 0x06, 0x75, 0x08,
+    0x15, 0x00, 0x25, 0x65, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00, 0xC0, 0x05, 0x0C, 0x09, 0x01, 0xA1, 0x01,
+    0x85, 0x02, 0x15, 0x00, 0x26, 0xFF, 0x03, 0x19, 0x00, 0x2A, 0xFF, 0x03, 0x75, 0x10, 0x95, 0x01, 0x81,
+    0x00, 0xC0,
+};
+
+// Essence report keys (big endian): buttons in the code field, wheel bits on top.
+static constexpr uint16_t KEY_UP = 0x0006;
+static constexpr uint16_t KEY_DOWN = 0x0001;
+static constexpr uint16_t KEY_LEFT = 0x000b;
+static constexpr uint16_t KEY_RELEASE = 0x0000;
+static constexpr uint16_t KEY_RIGHT_TICK = 0x4000;
+
+static constexpr uint8_t CONTROL_UP = 0;
+static constexpr uint8_t CONTROL_LEFT = 2;
+static constexpr uint8_t CONTROL_WHEEL = 4;
+
+// -----------------------------------------------------------------------------
+// An Essence pipeline driven in milliseconds, recording the events it emits.
+// -----------------------------------------------------------------------------
+class PipelineTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    this->pipeline.set_profile(&PROFILE_ESSENCE);
+    this->pipeline.set_gestures(&GESTURES_ESSENCE);
+    this->pipeline.set_sink([this](const RemoteEvent &event) {
+      char buf[ACTION_NAME_BUF_SIZE];
+      this->events.push_back(event);
+      this->actions.emplace_back(event_action_name(event, buf));
+    });
+  }
+
+  ButtonConfig &config(uint8_t button) { return this->pipeline.gestures().config((ButtonId) button); }
+
+  void report(uint16_t key, uint32_t t_ms) {
+    const uint8_t data[2] = {(uint8_t) (key >> 8), (uint8_t) key};
+    NotifyRecord rec;
+    rec.assign(0, data, sizeof(data), t_ms * 1000);
+    this->pipeline.feed(rec);
+  }
+  void poll(uint32_t t_ms) { this->pipeline.poll(t_ms * 1000, t_ms); }
+  void click(uint16_t key, uint32_t t_ms, uint32_t hold_ms = 80) {
+    this->report(key, t_ms);
+    this->report(KEY_RELEASE, t_ms + hold_ms);
+  }
+
+  // Actions other than *_pressed / *_released, in order.
+  std::vector<std::string> gestures() const {
+    std::vector<std::string> out;
+    for (const std::string &a : this->actions) {
+      if (a.find("_pressed") == std::string::npos && a.find("_released") == std::string::npos)
+        out.push_back(a);
+    }
+    return out;
+  }
+
+  EventPipeline pipeline;
+  std::vector<RemoteEvent> events;
+  std::vector<std::string> actions;
+};
+
+using Strings = std::vector<std::string>;
+
+// -----------------------------------------------------------------------------
+// Report map parsing
+// -----------------------------------------------------------------------------
+TEST(ReportMap, ParsesConsumerPressAndRelease) {
+  HIDReportMap *map = HIDReportMap::parse_report_map_data(REPORT_MAP, sizeof(REPORT_MAP));
+  ASSERT_NE(map, nullptr);
+
+  uint8_t press[] = {0x02, 0xE9, 0x00};
+  std::vector<HIDReportItemValue> values = map->parse(press);
+  ASSERT_EQ(values.size(), 1u);
+  EXPECT_EQ(values[0].usage.page, 0x0C);
+  EXPECT_EQ(values[0].usage.usage, 0xE9);
+  EXPECT_EQ(values[0].value, 1);
+
+  // Held: no change, no value.
+  EXPECT_TRUE(map->parse(press).empty());
+
+  uint8_t release[] = {0x02, 0x00, 0x00};
+  values = map->parse(release);
+  ASSERT_EQ(values.size(), 1u);
+  EXPECT_EQ(values[0].usage.usage, 0xE9);
+  EXPECT_EQ(values[0].value, 0);
+  delete map;
+}
+
+TEST(ReportMap, ParsesKeyboardModifiersAndKeys) {
+  HIDReportMap *map = HIDReportMap::parse_report_map_data(REPORT_MAP, sizeof(REPORT_MAP));
+  ASSERT_NE(map, nullptr);
+
+  // Left shift + 'a' (0x04).
+  uint8_t report[] = {0x01, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00};
+  std::vector<HIDReportItemValue> values = map->parse(report);
+  bool shift = false;
+  bool key_a = false;
+  for (const HIDReportItemValue &v : values) {
+    EXPECT_EQ(v.usage.page, 0x07);
+    shift |= v.usage.usage == 0xE1 && v.value == 1;
+    key_a |= v.usage.usage == 0x04 && v.value == 1;
+  }
+  EXPECT_TRUE(shift);
+  EXPECT_TRUE(key_a);
+  delete map;
+}
+
+// -----------------------------------------------------------------------------
+// ReportDecoder: edges from diffing consecutive reports
+// -----------------------------------------------------------------------------
+TEST(ReportDecoder, PressAndRelease) {
+  ReportDecoder decoder;
+  decoder.set_profile(&PROFILE_ESSENCE);
+  ControlEdge edges[MAX_EDGES_PER_REPORT];
+
+  ASSERT_EQ(decoder.decode(KEY_UP, edges), 1);
+  EXPECT_EQ(edges[0].kind, EdgeKind::PRESS);
+  EXPECT_EQ(edges[0].control, CONTROL_UP);
+  EXPECT_EQ(edges[0].code, KEY_UP);
+
+  // The same report again is no edge.
+  EXPECT_EQ(decoder.decode(KEY_UP, edges), 0);
+
+  ASSERT_EQ(decoder.decode(KEY_RELEASE, edges), 1);
+  EXPECT_EQ(edges[0].kind, EdgeKind::RELEASE);
+  EXPECT_EQ(edges[0].control, CONTROL_UP);
+}
+
+TEST(ReportDecoder, CodeChangeReleasesFirst) {
+  ReportDecoder decoder;
+  decoder.set_profile(&PROFILE_ESSENCE);
+  ControlEdge edges[MAX_EDGES_PER_REPORT];
+
+  decoder.decode(KEY_UP, edges);
+  ASSERT_EQ(decoder.decode(KEY_LEFT, edges), 2);
+  EXPECT_EQ(edges[0].kind, EdgeKind::RELEASE);
+  EXPECT_EQ(edges[0].control, CONTROL_UP);
+  EXPECT_EQ(edges[1].kind, EdgeKind::PRESS);
+  EXPECT_EQ(edges[1].control, CONTROL_LEFT);
+}
+
+TEST(ReportDecoder, WheelTicksOnEveryReport) {
+  ReportDecoder decoder;
+  decoder.set_profile(&PROFILE_ESSENCE);
+  ControlEdge edges[MAX_EDGES_PER_REPORT];
+
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(decoder.decode(KEY_RIGHT_TICK, edges), 1);
+    EXPECT_EQ(edges[0].kind, EdgeKind::TICK);
+    EXPECT_EQ(edges[0].control, CONTROL_WHEEL);
+    EXPECT_EQ(edges[0].direction, 1);
+  }
+  // A tick while a button is held neither presses nor releases it.
+  decoder.decode(KEY_UP, edges);
+  ASSERT_EQ(decoder.decode(KEY_UP | KEY_RIGHT_TICK, edges), 1);
+  EXPECT_EQ(edges[0].kind, EdgeKind::TICK);
+  EXPECT_EQ(decoder.decode(KEY_UP, edges), 0);
+}
+
+TEST(ReportDecoder, UnknownCode) {
+  ReportDecoder decoder;
+  decoder.set_profile(&PROFILE_ESSENCE);
+  ControlEdge edges[MAX_EDGES_PER_REPORT];
+
+  ASSERT_EQ(decoder.decode(0x0123, edges), 1);
+  EXPECT_EQ(edges[0].kind, EdgeKind::UNKNOWN);
+  EXPECT_EQ(edges[0].code, 0x0123);
+}
+
+// -----------------------------------------------------------------------------
+// GestureEngine, through the pipeline
+// -----------------------------------------------------------------------------
+TEST_F(PipelineTest, SingleClick) {
+  this->click(KEY_UP, 0);
+  this->poll(300);
+  EXPECT_EQ(this->gestures(), Strings{});
+  this->poll(500);
+  EXPECT_EQ(this->actions, (Strings{"up_pressed", "up_released", "up_single"}));
+  EXPECT_EQ(this->events.back().clicks, 1);
+}
+
+TEST_F(PipelineTest, DoubleClick) {
+  this->click(KEY_UP, 0);
+  this->click(KEY_UP, 250);
+  this->poll(1000);
+  EXPECT_EQ(this->gestures(), Strings{"up_double"});
+  EXPECT_EQ(this->events.back().clicks, 2);
+}
+
+TEST_F(PipelineTest, TripleClickEmitsAtOnce) {
+  this->click(KEY_UP, 0);
+  this->click(KEY_UP, 250);
+  this->click(KEY_UP, 500);
+  EXPECT_EQ(this->gestures(), Strings{"up_triple"});
+}
+
+TEST_F(PipelineTest, ClicksApartAreSingles) {
+  this->click(KEY_UP, 0);
+  this->poll(490);
+  this->click(KEY_UP, 1000);
+  this->poll(2000);
+  EXPECT_EQ(this->gestures(), (Strings{"up_single", "up_single"}));
+}
+
+TEST_F(PipelineTest, OtherButtonEndsSequence) {
+  this->click(KEY_UP, 0);
+  this->click(KEY_DOWN, 200);
+  this->poll(1000);
+  EXPECT_EQ(this->gestures(), (Strings{"up_single", "down_single"}));
+}
+
+TEST_F(PipelineTest, LongPress) {
+  this->report(KEY_UP, 0);
+  this->poll(1400);
+  EXPECT_EQ(this->gestures(), Strings{});
+  this->poll(1500);
+  EXPECT_EQ(this->gestures(), Strings{"up_long"});
+  this->report(KEY_RELEASE, 2000);
+  this->poll(3000);
+  EXPECT_EQ(this->actions, (Strings{"up_pressed", "up_long", "up_released"}));
+}
+
+TEST_F(PipelineTest, RepeatRampsUp) {
+  ButtonConfig &cfg = this->config(CONTROL_UP);
+  cfg.repeat = true;
+  cfg.repeat_delay_ms = 500;
+  cfg.repeat_interval_ms = 200;
+  cfg.repeat_min_interval_ms = 100;
+  cfg.repeat_ramp_q8 = 128;  // halves
+  this->report(KEY_UP, 0);
+  // Repeats at 500, 700 (200), 800 (100, the minimum), 900.
+  for (uint32_t t = 0; t <= 950; t += 10)
+    this->poll(t);
+  EXPECT_EQ(this->gestures(), (Strings{"up_repeat", "up_repeat", "up_repeat", "up_repeat"}));
+  for (uint16_t i = 0; i < 4; i++)
+    EXPECT_EQ(this->events[1 + i].repeat, i + 1);
+  // A hold that repeated is no click.
+  this->report(KEY_RELEASE, 960);
+  this->poll(2000);
+  EXPECT_EQ(this->actions.back(), "up_released");
+}
+
+TEST_F(PipelineTest, RepeatRunHasNoLongPress) {
+  this->config(CONTROL_UP).repeat = true;
+  this->report(KEY_UP, 0);
+  for (uint32_t t = 0; t <= 2000; t += 16)
+    this->poll(t);
+  this->report(KEY_RELEASE, 2010);
+  this->poll(3000);
+  const Strings g = this->gestures();
+  ASSERT_GT(g.size(), 7u);
+  for (const std::string &a : g)
+    EXPECT_EQ(a, "up_repeat");
+}
+
+TEST_F(PipelineTest, RepeatAfterLongPress) {
+  ButtonConfig &cfg = this->config(CONTROL_UP);
+  cfg.repeat = true;
+  cfg.repeat_delay_ms = 2000;
+  this->report(KEY_UP, 0);
+  for (uint32_t t = 0; t <= 2300; t += 16)
+    this->poll(t);
+  EXPECT_EQ(this->gestures(), (Strings{"up_long", "up_repeat", "up_repeat"}));
+}
+
+TEST_F(PipelineTest, AdaptiveWindowLearnsDoubleClicks) {
+  AdaptiveGapWindow &adaptive = this->pipeline.gestures().adaptive();
+  adaptive.configure(150, 1000, 95, 50);
+  for (uint32_t i = 0; i < 10; i++) {
+    this->click(KEY_UP, i * 2000);
+    this->click(KEY_UP, i * 2000 + 250);
+    this->poll(i * 2000 + 1000);
+  }
+  // 170 ms gaps: the 175 ms bin plus the margin.
+  EXPECT_EQ(adaptive.window_ms(), 225u);
+  EXPECT_EQ(adaptive.samples(), 10u);
+}
+
+TEST_F(PipelineTest, AdaptiveWindowIgnoresSpacedSingles) {
+  AdaptiveGapWindow &adaptive = this->pipeline.gestures().adaptive();
+  adaptive.configure(150, 1000, 95, 50);
+  const uint32_t window = adaptive.window_ms();
+  // 820 ms from release to press: under max_gap, far past the window.
+  for (uint32_t i = 0; i < 20; i++) {
+    this->click(KEY_UP, i * 900);
+    this->poll(i * 900 + 890);
+  }
+  EXPECT_EQ(this->gestures(), Strings(20, "up_single"));
+  EXPECT_EQ(adaptive.window_ms(), window);
+  EXPECT_EQ(adaptive.samples(), 0u);
+  EXPECT_FALSE(this->pipeline.gestures().take_window_changed());
+}
+
+// A stalled loop(): the reports were stamped on arrival, loop() feeds
+// them only when it runs again, well past every gesture deadline.
+TEST_F(PipelineTest, StalledLoopShortPressIsSingle) {
+  this->click(KEY_UP, 0, 100);
+  this->poll(2000);
+  EXPECT_EQ(this->actions, (Strings{"up_pressed", "up_released", "up_single"}));
+}
+
+TEST_F(PipelineTest, StalledLoopLongPress) {
+  this->click(KEY_UP, 0, 1600);
+  this->poll(2500);
+  EXPECT_EQ(this->actions, (Strings{"up_pressed", "up_long", "up_released"}));
+}
+
+TEST_F(PipelineTest, StalledLoopDoubleClick) {
+  this->click(KEY_UP, 0);
+  this->click(KEY_UP, 250);
+  this->poll(1200);
+  EXPECT_EQ(this->gestures(), Strings{"up_double"});
+}
+
+TEST_F(PipelineTest, StalledLoopClicksApartAreSingles) {
+  this->click(KEY_UP, 0);
+  this->click(KEY_UP, 600);
+  this->poll(1500);
+  EXPECT_EQ(this->gestures(), (Strings{"up_single", "up_single"}));
+}
+
+TEST_F(PipelineTest, WheelWhileHeldIsChord) {
+  this->report(KEY_UP, 0);
+  this->report(KEY_UP | KEY_RIGHT_TICK, 100);
+  this->poll(110);
+  this->report(KEY_UP, 120);
+  this->report(KEY_RELEASE, 300);
+  this->poll(2000);
+  EXPECT_EQ(this->gestures(), Strings{"up+rotate_right"});
+  EXPECT_NE(this->events[1].gesture, 0);
+  EXPECT_EQ(this->events[1].steps, 1);
+}
+
+TEST_F(PipelineTest, WheelAloneRotates) {
+  this->report(KEY_RIGHT_TICK, 0);
+  this->report(KEY_RELEASE, 10);
+  this->report(KEY_RIGHT_TICK, 20);
+  this->poll(30);
+  EXPECT_EQ(this->actions, Strings{"rotate_right"});
+  EXPECT_EQ(this->events[0].steps, 2);
+  EXPECT_EQ(this->events[0].raw, KEY_RIGHT_TICK);
+}
+
+// -----------------------------------------------------------------------------
+// Wheel acceleration and coalescing
+// -----------------------------------------------------------------------------
+TEST(WheelAcceleration, LinearScalesAcrossSpeedRange) {
+  WheelAcceleration acc;
+  acc.set_curve(WheelCurve::LINEAR);
+  acc.set_speed_range(0, 100);
+  EXPECT_EQ(acc.factor_q8(0), WHEEL_FACTOR_ONE);
+  EXPECT_EQ(acc.factor_q8(50), 640u);  // halfway to 4.0
+  EXPECT_EQ(acc.factor_q8(100), 4 * WHEEL_FACTOR_ONE);
+  EXPECT_EQ(acc.factor_q8(1000), 4 * WHEEL_FACTOR_ONE);
+}
+
+TEST(WheelAcceleration, PowerBendsTheCurve) {
+  WheelAcceleration acc;
+  acc.set_curve(WheelCurve::POWER);
+  acc.set_speed_range(0, 100);
+  EXPECT_EQ(acc.factor_q8(50), 448u);  // 1 + 3 * 0.5^2
+  acc.set_exponent(3);
+  EXPECT_EQ(acc.factor_q8(50), 352u);  // 1 + 3 * 0.5^3
+  EXPECT_EQ(acc.factor_q8(100), 4 * WHEEL_FACTOR_ONE);
+}
+
+TEST(WheelAcceleration, TableInterpolatesAndClampsToEnds) {
+  WheelAcceleration acc;
+  acc.set_curve(WheelCurve::TABLE);
+  EXPECT_EQ(acc.factor_q8(50), WHEEL_FACTOR_ONE);  // no points
+  acc.add_point(10, 256);
+  acc.add_point(20, 512);
+  acc.add_point(30, 1024);
+  EXPECT_EQ(acc.factor_q8(0), 256u);
+  EXPECT_EQ(acc.factor_q8(10), 256u);
+  EXPECT_EQ(acc.factor_q8(15), 384u);
+  EXPECT_EQ(acc.factor_q8(25), 768u);
+  EXPECT_EQ(acc.factor_q8(30), 1024u);
+  EXPECT_EQ(acc.factor_q8(500), 1024u);
+}
+
+TEST(WheelAcceleration, TableEqualSpeedPointsStep) {
+  WheelAcceleration acc;
+  acc.set_curve(WheelCurve::TABLE);
+  acc.add_point(10, 256);
+  acc.add_point(20, 512);
+  acc.add_point(20, 1024);
+  acc.add_point(30, 1024);
+  EXPECT_EQ(acc.factor_q8(20), 512u);
+  EXPECT_EQ(acc.factor_q8(21), 1024u);
+}
+
+// A one-point table: every tick weighs `factor_q8` whatever the speed.
+static void set_flat_factor(WheelCoalescer &wheel, uint32_t factor_q8) {
+  wheel.acceleration().set_curve(WheelCurve::TABLE);
+  wheel.acceleration().add_point(0, factor_q8);
+}
+
+TEST(WheelCoalescer, CarriesRemainderToNextEvent) {
+  WheelCoalescer wheel;
+  set_flat_factor(wheel, 384);  // 1.5 steps per tick
+  WheelFlush out;
+  wheel.add_tick(1, 0, out);
+  ASSERT_TRUE(wheel.end_batch(0, out));
+  EXPECT_EQ(out.delta, 1);
+  wheel.add_tick(1, 10000, out);
+  ASSERT_TRUE(wheel.end_batch(10, out));
+  EXPECT_EQ(out.delta, 2);
+  EXPECT_EQ(out.steps, 1);
+}
+
+TEST(WheelCoalescer, PauseDropsRemainder) {
+  WheelCoalescer wheel;
+  set_flat_factor(wheel, 384);
+  WheelFlush out;
+  wheel.add_tick(1, 0, out);
+  ASSERT_TRUE(wheel.end_batch(0, out));
+  wheel.add_tick(1, 500000, out);  // past the velocity window
+  ASSERT_TRUE(wheel.end_batch(500, out));
+  EXPECT_EQ(out.delta, 1);
+}
+
+TEST(WheelCoalescer, DirectionChangeDropsRemainder) {
+  WheelCoalescer wheel;
+  set_flat_factor(wheel, 384);
+  WheelFlush out;
+  wheel.add_tick(1, 0, out);
+  ASSERT_TRUE(wheel.end_batch(0, out));
+  EXPECT_EQ(out.delta, 1);
+  EXPECT_FALSE(wheel.add_tick(-1, 10000, out));  // nothing pending to flush
+  ASSERT_TRUE(wheel.end_batch(10, out));
+  EXPECT_EQ(out.direction, -1);
+  EXPECT_EQ(out.delta, -1);
+}
+
+TEST(WheelCoalescer, DirectionChangeFlushesPendingRun) {
+  WheelCoalescer wheel;
+  WheelFlush out;
+  wheel.add_tick(1, 0, out);
+  wheel.add_tick(1, 5000, out);
+  ASSERT_TRUE(wheel.add_tick(-1, 10000, out));
+  EXPECT_EQ(out.direction, 1);
+  EXPECT_EQ(out.steps, 2);
+  EXPECT_EQ(out.delta, 2);
+}
+
+TEST(WheelCoalescer, DeltaClampsToInt16) {
+  WheelCoalescer wheel;
+  set_flat_factor(wheel, 40000 * WHEEL_FACTOR_ONE);
+  WheelFlush out;
+  wheel.add_tick(1, 0, out);
+  ASSERT_TRUE(wheel.end_batch(0, out));
+  EXPECT_EQ(out.delta, INT16_MAX);
+  wheel.add_tick(-1, 10000, out);
+  ASSERT_TRUE(wheel.end_batch(10, out));
+  EXPECT_EQ(out.delta, -INT16_MAX);
+}
+
+// -----------------------------------------------------------------------------
+// EventText
+// -----------------------------------------------------------------------------
+TEST(EventText, FormatsNamedEvent) {
+  RemoteEvent event{"up_single", 0x0006, true, 1};
+  const EventText text(event);
+  EXPECT_STREQ(text.action, "up_single");
+  EXPECT_STREQ(text.raw, "0006");
+  EXPECT_STREQ(text.clicks, "1");
+}
+
+TEST(EventText, FormatsUnknownAndNoRaw) {
+  RemoteEvent unknown{nullptr, 0xBEEF, true, -1};
+  const EventText text(unknown);
+  EXPECT_STREQ(text.action, "raw_beef");
+  EXPECT_STREQ(text.raw, "beef");
+  EXPECT_STREQ(text.clicks, "-1");
+
+  RemoteEvent gesture{"up_double", 0, false, 2};
+  const EventText g(gesture);
+  EXPECT_STREQ(g.raw, "");
+  EXPECT_STREQ(g.clicks, "2");
+}
+
+TEST(EventText, EventDataCarriesOptionalFields) {
+  RemoteEvent event{"rotate_right", 0x4000, true, -1};
+  event.steps = 3;
+  event.delta = -6;
+  const EventText text(event);
+  const auto data = event_data(event, text, "AA:BB", "node", "tv");
+  EXPECT_EQ(data.at("action"), "rotate_right");
+  EXPECT_EQ(data.at("steps"), "3");
+  EXPECT_EQ(data.at("delta"), "-6");
+  EXPECT_EQ(data.at("remote"), "AA:BB");
+  EXPECT_EQ(data.at("mode"), "tv");
+  EXPECT_EQ(data.count("repeat"), 0u);
+}
+
+// notify to EventText, as emit_event does before the API data: no heap.
+TEST(EventText, NotifyToTextDoesNotAllocate) {
+  EventPipeline pipeline;
+  pipeline.set_profile(&PROFILE_ESSENCE);
+  pipeline.set_gestures(&GESTURES_ESSENCE);
+  size_t events = 0;
+  size_t text_bytes = 0;
+  pipeline.set_sink([&](const RemoteEvent &event) {
+    const EventText text(event);
+    events++;
+    text_bytes += std::strlen(text.action) + std::strlen(text.raw) + std::strlen(text.clicks);
+  });
+  const uint16_t keys[] = {KEY_UP, KEY_RELEASE, KEY_UP, KEY_RELEASE, KEY_RIGHT_TICK, KEY_RELEASE,
+                           KEY_LEFT, KEY_RELEASE};
+  uint32_t t_ms = 0;
+  auto run = [&] {
+    for (uint16_t key : keys) {
+      const uint8_t data[2] = {(uint8_t) (key >> 8), (uint8_t) key};
+      NotifyRecord rec;
+      rec.assign(0, data, sizeof(data), t_ms * 1000);
+      pipeline.feed(rec);
+      pipeline.poll(t_ms * 1000, t_ms);
+      t_ms += 60;
+    }
+    for (uint32_t end = t_ms + 2000; t_ms < end; t_ms += 16)
+      pipeline.poll(t_ms * 1000, t_ms);
+  };
+  run();  // first use may size anything lazily
+  const size_t warm_events = events;
+  const uint64_t start = g_allocs.load();
+  run();
+  EXPECT_EQ(g_allocs.load() - start, 0u);
+  EXPECT_EQ(events, 2 * warm_events);
+  EXPECT_GT(warm_events, 0u);
+  EXPECT_GT(text_bytes, 0u);
+}
+
+// -----------------------------------------------------------------------------
+// Capture
+// -----------------------------------------------------------------------------
+TEST(Capture, RoundTripsProfileAndRecords) {
+  CaptureRing ring;
+  ring.set_capacity(4);
+  const uint8_t up[2] = {0x00, 0x06};
+  NotifyRecord rec;
+  rec.assign(30, up, sizeof(up), 1000);
+  ring.add(0xAABBCCDDEEFFull, rec);
+  std::vector<uint8_t> bytes;
+  ring.write("essence", GESTURES_ESSENCE.state_count,
+             [&bytes](const uint8_t *data, size_t len) { bytes.insert(bytes.end(), data, data + len); });
+
+  CaptureReader reader;
+  ASSERT_TRUE(reader.open(bytes.data(), bytes.size()));
+  EXPECT_STREQ(reader.profile(), "essence");
+  EXPECT_EQ(reader.gesture_states(), GESTURES_ESSENCE.state_count);
+  EXPECT_EQ(reader.remote(0), 0xAABBCCDDEEFFull);
+  CaptureRecord out;
+  ASSERT_TRUE(reader.next(out));
+  EXPECT_EQ(out.t_us, 1000u);
+  EXPECT_EQ(out.handle, 30);
+  EXPECT_EQ(out.data[1], 0x06);
+  EXPECT_FALSE(reader.next(out));
+
+  bytes.resize(8);  // header cut inside the profile name
+  EXPECT_FALSE(reader.open(bytes.data(), bytes.size()));
+}
+
+// -----------------------------------------------------------------------------
+// ConnectionScheduler
+// -----------------------------------------------------------------------------
+static constexpr uint64_t REMOTE_A = 0xAABBCCDDEE01ull;
+static constexpr uint64_t REMOTE_B = 0xAABBCCDDEE02ull;
+
+TEST(ConnectionScheduler, ReleasesIdlePooledLink) {
+  ConnectionScheduler pool;
+  pool.add_remote(REMOTE_A);
+  pool.add_remote(REMOTE_B);
+  pool.set_idle_release_ms(30000);
+  EXPECT_FALSE(pool.should_release(100000));  // not connected
+  pool.on_connected(1000);
+  EXPECT_FALSE(pool.should_release(30999));
+  EXPECT_TRUE(pool.should_release(31000));
+  uint32_t latency_ms;
+  pool.on_activity(20000, latency_ms);
+  EXPECT_FALSE(pool.should_release(31000));
+  EXPECT_TRUE(pool.should_release(50000));
+  pool.on_disconnected();
+  EXPECT_FALSE(pool.should_release(50000));
+}
+
+TEST(ConnectionScheduler, SingleRemoteIsNeverReleased) {
+  ConnectionScheduler pool;
+  pool.add_remote(REMOTE_A);
+  EXPECT_FALSE(pool.add_remote(REMOTE_A));
+  pool.set_idle_release_ms(30000);
+  pool.on_connected(0);
+  EXPECT_FALSE(pool.is_pooled());
+  EXPECT_FALSE(pool.should_release(100000));
+}
+
+TEST(ConnectionScheduler, RetargetsToPooledRemoteWhenSlotIsFree) {
+  ConnectionScheduler pool;
+  pool.add_remote(REMOTE_A);
+  pool.add_remote(REMOTE_B);
+  EXPECT_EQ(pool.on_advertisement(0x112233445566ull, true, 0), POOL_NONE);  // not ours
+  EXPECT_EQ(pool.on_advertisement(REMOTE_B, false, 0), POOL_NONE);          // slot busy
+  EXPECT_EQ(pool.current(), POOL_NONE);
+  EXPECT_EQ(pool.on_advertisement(REMOTE_B, true, 1000), 1);
+  EXPECT_EQ(pool.current(), 1);
+  pool.on_connected(1200);
+
+  // The first input after the wake reports its latency, once.
+  uint32_t latency_ms = 0;
+  EXPECT_TRUE(pool.on_activity(1450, latency_ms));
+  EXPECT_EQ(latency_ms, 450u);
+  EXPECT_FALSE(pool.on_activity(1600, latency_ms));
+  EXPECT_EQ(pool.remote(1).wakes, 1);
+  EXPECT_EQ(pool.remote(1).worst_latency_ms, 450u);
+  EXPECT_EQ(pool.remote(0).wakes, 0);
+}
+
+TEST(ConnectionScheduler, WakeWithoutInputDoesNotCount) {
+  ConnectionScheduler pool;
+  pool.add_remote(REMOTE_A);
+  pool.add_remote(REMOTE_B);
+  EXPECT_EQ(pool.on_advertisement(REMOTE_A, true, 1000), 0);
+  pool.on_connected(1100);
+  pool.on_disconnected();
+  EXPECT_EQ(pool.on_advertisement(REMOTE_A, true, 5000), 0);
+  uint32_t latency_ms = 0;
+  EXPECT_TRUE(pool.on_activity(5300, latency_ms));
+  EXPECT_EQ(latency_ms, 300u);  // from the second wake
+  EXPECT_EQ(pool.remote(0).wakes, 1);
+}
+
+// -----------------------------------------------------------------------------
+// ConnParamPolicy
+// -----------------------------------------------------------------------------
+TEST(ConnParamPolicy, UnansweredUpdateExpires) {
+  ConnParamPolicy policy;
+  // 6 s supervision timeout: an update is lost after 12 s.
+  policy.configure(LinkParams{12, 12, 0, 600}, LinkParams{80, 100, 4, 600}, 5000);
+  policy.reset(0);
+  ASSERT_TRUE(policy.poll(5000));
+  EXPECT_EQ(policy.requested(), LinkProfile::IDLE);
+  EXPECT_FALSE(policy.update_expired(16999));
+  EXPECT_TRUE(policy.update_expired(17000));
+  EXPECT_FALSE(policy.update_expired(17001));
+  // Treated as refused: not asked for again while the link stays quiet.
+  EXPECT_EQ(policy.requested(), LinkProfile::NONE);
+  EXPECT_FALSE(policy.poll(17100));
+}
+
+TEST(ConnParamPolicy, RefusedProfileIsNotRequestedAgain) {
+  ConnParamPolicy policy;
+  policy.configure(LinkParams{12, 12, 0, 600}, LinkParams{80, 100, 4, 600}, 5000);
+  policy.reset(0);
+  ASSERT_TRUE(policy.on_input(1000));
+  policy.on_updated(12);
+  ASSERT_TRUE(policy.poll(6000));
+  policy.on_request_failed();
+  EXPECT_EQ(policy.requested(), LinkProfile::ACTIVE);
+  uint32_t requests = 0;
+  for (uint32_t t = 6016; t < 120000; t += 16)
+    requests += policy.poll(t);
+  EXPECT_EQ(requests, 0u);
+  // Still on the fast link: input asks for nothing.
+  EXPECT_FALSE(policy.on_input(120000));
+  // The next quiet period tries the idle profile once more.
+  EXPECT_TRUE(policy.poll(125000));
+  policy.on_request_failed();
+  EXPECT_FALSE(policy.poll(126000));
+}
+
+TEST(ConnParamPolicy, AnsweredUpdateDoesNotExpire) {
+  ConnParamPolicy policy;
+  policy.configure(LinkParams{12, 12, 0, 600}, LinkParams{80, 100, 4, 600}, 5000);
+  policy.reset(0);
+  ASSERT_TRUE(policy.poll(5000));
+  policy.on_updated(90);
+  EXPECT_FALSE(policy.update_expired(30000));
+  // Input while idle switches back to the fast profile.
+  EXPECT_TRUE(policy.on_input(30000));
+  EXPECT_EQ(policy.requested(), LinkProfile::ACTIVE);
+}
+
+}  // namespace
+}  // namespace ble_client_hid
+}  // namespace esphome
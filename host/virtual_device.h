@@ -0,0 +1,139 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "event_pipeline.h"
+#include "notify_queue.h"
+
+namespace esphome {
+namespace ble_client_hid {
+
+// An event as the sink saw it, with virtual times (micros since the start of
+// the run) and the host CPU time of the call that produced it.
+struct EmittedEvent {
+  RemoteEvent event;
+  uint64_t emit_us{0};     // loop() iteration that sent it
+  bool from_record{false};  // decoding a record produced it, not a deadline in poll()
+  uint64_t arrival_us{0};   // from_record: arrival of that record
+  uint32_t cpu_ns{0};       // the call's CPU time, split evenly across its events
+};
+
+using EmittedSink = std::function<void(const EmittedEvent &event)>;
+
+// -----------------------------------------------------------------------------
+// One BLEClientHID on a virtual clock. Notifications enter the notify queue at
+// their arrival time; loop() runs every loop_us, drains a batch through the
+// pipeline and polls it, as on the device. No sleeping: a run is deterministic
+// apart from the measured CPU times, and as fast as the host.
+// -----------------------------------------------------------------------------
+class VirtualDevice {
+ public:
+  VirtualDevice() {
+    this->pipeline_.set_sink([this](const RemoteEvent &event) { this->pending_.push_back(event); });
+    this->pending_.reserve(64);
+  }
+
+  EventPipeline &pipeline() { return this->pipeline_; }
+  void set_sink(EmittedSink sink) { this->sink_ = std::move(sink); }
+  // Device timestamps are base_us + virtual time, so captured stamps replay as they were.
+  void set_base_us(uint32_t base_us) { this->base_us_ = base_us; }
+  void set_loop_us(uint32_t loop_us) { this->loop_us_ = loop_us > 0 ? loop_us : 1; }
+  // Every `every_us`, one loop() iteration runs `stall_us` late.
+  void set_stall(uint32_t stall_us, uint32_t every_us) {
+    this->stall_us_ = stall_us;
+    this->stall_every_us_ = every_us;
+    this->next_stall_us_ = every_us;
+  }
+
+  // Queues a notification at virtual time `at_us`; runs the loop iterations due before it.
+  // False if the queue was full.
+  bool arrive(uint64_t at_us, uint16_t handle, const uint8_t *data, uint8_t len) {
+    this->run_until(at_us);
+    NotifyRecord rec;
+    rec.assign(handle, data, len, this->device_us_(at_us));
+    if (!this->queue_.push(rec)) {
+      this->overflows_++;
+      return false;
+    }
+    if (this->queue_.size() > this->max_depth_)
+      this->max_depth_ = this->queue_.size();
+    return true;
+  }
+
+  // Runs every loop() iteration scheduled before `until_us`.
+  void run_until(uint64_t until_us) {
+    while (this->next_loop_us_ < until_us) {
+      if (this->stall_every_us_ > 0 && this->next_loop_us_ >= this->next_stall_us_) {
+        // This iteration runs late; arrivals before it queue up.
+        this->next_loop_us_ += this->stall_us_;
+        this->next_stall_us_ = this->next_loop_us_ + this->stall_every_us_;
+        this->stalls_++;
+        continue;
+      }
+      this->loop_(this->next_loop_us_);
+      this->next_loop_us_ += this->loop_us_;
+    }
+  }
+
+  uint64_t loops() const { return this->loops_; }
+  uint32_t stalls() const { return this->stalls_; }
+  uint32_t overflows() const { return this->overflows_; }
+  size_t max_depth() const { return this->max_depth_; }
+  size_t depth() const { return this->queue_.size(); }
+
+ protected:
+  uint32_t device_us_(uint64_t t_us) const { return (uint32_t) (this->base_us_ + t_us); }
+
+  void loop_(uint64_t now_us) {
+    this->loops_++;
+    NotifyRecord rec;
+    for (uint8_t drained = 0; drained < NOTIFY_DRAIN_BATCH && this->queue_.pop(rec); drained++) {
+      const auto start = std::chrono::steady_clock::now();
+      this->pipeline_.feed(rec);
+      // Wrap-safe: a record waits far less than the 32-bit clock's period.
+      this->flush_(now_us, start, true, now_us - (uint32_t) (this->device_us_(now_us) - rec.t_us));
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t ms = ((uint64_t) this->base_us_ + now_us) / 1000;
+    this->pipeline_.poll(this->device_us_(now_us), (uint32_t) ms);
+    this->flush_(now_us, start, false, 0);
+  }
+
+  void flush_(uint64_t now_us, std::chrono::steady_clock::time_point start, bool from_record, uint64_t arrival_us) {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    if (this->pending_.empty())
+      return;
+    EmittedEvent out;
+    out.emit_us = now_us;
+    out.from_record = from_record;
+    out.arrival_us = arrival_us;
+    out.cpu_ns = (uint32_t) (ns.count() / (int64_t) this->pending_.size());
+    for (const RemoteEvent &event : this->pending_) {
+      out.event = event;
+      if (this->sink_)
+        this->sink_(out);
+    }
+    this->pending_.clear();
+  }
+
+  EventPipeline pipeline_;
+  NotifyQueue queue_;
+  EmittedSink sink_;
+  std::vector<RemoteEvent> pending_;
+  uint32_t base_us_{0};
+  uint32_t loop_us_{16000};
+  uint32_t stall_us_{0};
+  uint32_t stall_every_us_{0};
+  uint64_t next_stall_us_{0};
+  uint64_t next_loop_us_{0};
+  uint64_t loops_{0};
+  uint32_t stalls_{0};
+  uint32_t overflows_{0};
+  size_t max_depth_{0};
+};
+
+}  // namespace ble_client_hid
+}  // namespace esphome